@@ -19,17 +19,32 @@ TOLUA_API int  tolua_level_layer_open (lua_State* tolua_S);
 #include "lua_level_layer.h"
 #include "level_layer.h"
 #include "game_manager.h"
+#include "physics_body_node.h"
+#include "stroke_builder.h"
+#include "stroke_batch_node.h"
+#include "stroke_node.h"
 #include "tolua_fix.h"
 
 /* function to register type */
 static void tolua_reg_types (lua_State* tolua_S)
 {
  tolua_usertype(tolua_S,"b2Vec2");
+ tolua_usertype(tolua_S,"b2Body");
+ tolua_usertype(tolua_S,"b2Fixture");
  tolua_usertype(tolua_S,"CCLayerColor");
  tolua_usertype(tolua_S,"LUA_FUNCTION");
+ tolua_usertype(tolua_S,"LUA_TABLE");
  tolua_usertype(tolua_S,"GameManager");
  tolua_usertype(tolua_S,"b2World");
+ tolua_usertype(tolua_S,"CCPhysicsNode");
+ tolua_usertype(tolua_S,"PhysicsBodyNode");
  tolua_usertype(tolua_S,"LevelLayer");
+ tolua_usertype(tolua_S,"CCNode");
+ tolua_usertype(tolua_S,"CCTexture2D");
+ tolua_usertype(tolua_S,"StrokeBatchNode");
+ tolua_usertype(tolua_S,"ccColor3B");
+ tolua_usertype(tolua_S,"StrokeNode");
+ tolua_usertype(tolua_S,"StrokeBuilder");
 }
 
 /* method: GetWorld of class  LevelLayer */
@@ -64,6 +79,141 @@ static int tolua_level_layer_LevelLayer_GetWorld00(lua_State* tolua_S)
 }
 #endif //#ifndef TOLUA_DISABLE
 
+/* method: GetStaticBody of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_GetStaticBody00
+static int tolua_level_layer_LevelLayer_GetStaticBody00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'GetStaticBody'", NULL);
+#endif
+  {
+   b2Body* tolua_ret = (b2Body*)  self->GetStaticBody();
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"b2Body");
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'GetStaticBody'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetFixtureTag of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetFixtureTag00
+static int tolua_level_layer_LevelLayer_SetFixtureTag00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isusertype(tolua_S,2,"b2Fixture",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  b2Fixture* fixture = ((b2Fixture*)  tolua_tousertype(tolua_S,2,0));
+  int tag = ((int)  tolua_tonumber(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetFixtureTag'", NULL);
+#endif
+  {
+   self->SetFixtureTag(fixture,tag);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetFixtureTag'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: AddStaticEdges of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_AddStaticEdges00
+static int tolua_level_layer_LevelLayer_AddStaticEdges00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE edges = ( toluafix_totable(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'AddStaticEdges'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->AddStaticEdges(edges);
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'AddStaticEdges'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: AddStaticBoxes of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_AddStaticBoxes00
+static int tolua_level_layer_LevelLayer_AddStaticBoxes00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE boxes = ( toluafix_totable(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'AddStaticBoxes'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->AddStaticBoxes(boxes);
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'AddStaticBoxes'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
 /* method: LevelComplete of class  LevelLayer */
 #ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_LevelComplete00
 static int tolua_level_layer_LevelLayer_LevelComplete00(lua_State* tolua_S)
@@ -80,24 +230,854 @@ static int tolua_level_layer_LevelLayer_LevelComplete00(lua_State* tolua_S)
  {
   LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
 #ifndef TOLUA_RELEASE
-  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'LevelComplete'", NULL);
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'LevelComplete'", NULL);
+#endif
+  {
+   self->LevelComplete();
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'LevelComplete'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: ToggleDebug of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_ToggleDebug00
+static int tolua_level_layer_LevelLayer_ToggleDebug00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'ToggleDebug'", NULL);
+#endif
+  {
+   self->ToggleDebug();
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'ToggleDebug'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: StepPhysics of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_StepPhysics00
+static int tolua_level_layer_LevelLayer_StepPhysics00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,4,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,5,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  float delta = ((float)  tolua_tonumber(tolua_S,2,0));
+  int velocity_iterations = ((int)  tolua_tonumber(tolua_S,3,0));
+  int position_iterations = ((int)  tolua_tonumber(tolua_S,4,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'StepPhysics'", NULL);
+#endif
+  {
+   self->StepPhysics(delta,velocity_iterations,position_iterations);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'StepPhysics'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: ApplyPhysicsSettings of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_ApplyPhysicsSettings00
+static int tolua_level_layer_LevelLayer_ApplyPhysicsSettings00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE settings = ( toluafix_totable(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'ApplyPhysicsSettings'", NULL);
+#endif
+  {
+   self->ApplyPhysicsSettings(settings);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'ApplyPhysicsSettings'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetPhysicsRate of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetPhysicsRate00
+static int tolua_level_layer_LevelLayer_SetPhysicsRate00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  float hz = ((float)  tolua_tonumber(tolua_S,2,0));
+  int max_steps = ((int)  tolua_tonumber(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetPhysicsRate'", NULL);
+#endif
+  {
+   self->SetPhysicsRate(hz,max_steps);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetPhysicsRate'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetPhysicsIterations of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetPhysicsIterations00
+static int tolua_level_layer_LevelLayer_SetPhysicsIterations00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  int velocity_iterations = ((int)  tolua_tonumber(tolua_S,2,0));
+  int position_iterations = ((int)  tolua_tonumber(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetPhysicsIterations'", NULL);
+#endif
+  {
+   self->SetPhysicsIterations(velocity_iterations,position_iterations);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetPhysicsIterations'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetNativeStep of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetNativeStep00
+static int tolua_level_layer_LevelLayer_SetNativeStep00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  bool enabled = ((bool)  tolua_toboolean(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetNativeStep'", NULL);
+#endif
+  {
+   self->SetNativeStep(enabled);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetNativeStep'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetPhysicsPaused of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetPhysicsPaused00
+static int tolua_level_layer_LevelLayer_SetPhysicsPaused00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  bool paused = ((bool)  tolua_toboolean(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetPhysicsPaused'", NULL);
+#endif
+  {
+   self->SetPhysicsPaused(paused);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetPhysicsPaused'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetThreadedPhysics of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetThreadedPhysics00
+static int tolua_level_layer_LevelLayer_SetThreadedPhysics00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  bool enabled = ((bool)  tolua_toboolean(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetThreadedPhysics'", NULL);
+#endif
+  {
+   self->SetThreadedPhysics(enabled);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetThreadedPhysics'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetPhysicsBudget of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetPhysicsBudget00
+static int tolua_level_layer_LevelLayer_SetPhysicsBudget00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  float budget_ms = ((float)  tolua_tonumber(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetPhysicsBudget'", NULL);
+#endif
+  {
+   self->SetPhysicsBudget(budget_ms);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetPhysicsBudget'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: GetPhysicsQuality of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_GetPhysicsQuality00
+static int tolua_level_layer_LevelLayer_GetPhysicsQuality00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'GetPhysicsQuality'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->GetPhysicsQuality();
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'GetPhysicsQuality'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetPostStepHandler of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetPostStepHandler00
+static int tolua_level_layer_LevelLayer_SetPostStepHandler00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_isfunction(tolua_S,2,"LUA_FUNCTION",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_FUNCTION handler = ( toluafix_ref_function(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetPostStepHandler'", NULL);
+#endif
+  {
+   self->SetPostStepHandler(handler);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetPostStepHandler'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetContactInterest of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetContactInterest00
+static int tolua_level_layer_LevelLayer_SetContactInterest00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,3,0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,4,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,5,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  int tag = ((int)  tolua_tonumber(tolua_S,2,0));
+  bool began = ((bool)  tolua_toboolean(tolua_S,3,0));
+  bool ended = ((bool)  tolua_toboolean(tolua_S,4,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetContactInterest'", NULL);
+#endif
+  {
+   self->SetContactInterest(tag,began,ended);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetContactInterest'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetGlobalContactInterest of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetGlobalContactInterest00
+static int tolua_level_layer_LevelLayer_SetGlobalContactInterest00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,2,0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  bool began = ((bool)  tolua_toboolean(tolua_S,2,0));
+  bool ended = ((bool)  tolua_toboolean(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetGlobalContactInterest'", NULL);
+#endif
+  {
+   self->SetGlobalContactInterest(began,ended);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetGlobalContactInterest'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetImpactThreshold of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetImpactThreshold00
+static int tolua_level_layer_LevelLayer_SetImpactThreshold00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  int tag = ((int)  tolua_tonumber(tolua_S,2,0));
+  float threshold = ((float)  tolua_tonumber(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetImpactThreshold'", NULL);
+#endif
+  {
+   self->SetImpactThreshold(tag,threshold);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetImpactThreshold'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetGlobalImpactThreshold of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetGlobalImpactThreshold00
+static int tolua_level_layer_LevelLayer_SetGlobalImpactThreshold00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  float threshold = ((float)  tolua_tonumber(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetGlobalImpactThreshold'", NULL);
+#endif
+  {
+   self->SetGlobalImpactThreshold(threshold);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetGlobalImpactThreshold'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: AddTrigger of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_AddTrigger00
+static int tolua_level_layer_LevelLayer_AddTrigger00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isusertype(tolua_S,3,"b2Vec2",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,4,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,5,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  int tag = ((int)  tolua_tonumber(tolua_S,2,0));
+  b2Vec2* center = ((b2Vec2*)  tolua_tousertype(tolua_S,3,0));
+  float radius = ((float)  tolua_tonumber(tolua_S,4,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'AddTrigger'", NULL);
+#endif
+  {
+   self->AddTrigger(tag,center,radius);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'AddTrigger'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: RemoveTrigger of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_RemoveTrigger00
+static int tolua_level_layer_LevelLayer_RemoveTrigger00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  int tag = ((int)  tolua_tonumber(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'RemoveTrigger'", NULL);
+#endif
+  {
+   self->RemoveTrigger(tag);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'RemoveTrigger'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetTriggerActivator of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_SetTriggerActivator00
+static int tolua_level_layer_LevelLayer_SetTriggerActivator00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isboolean(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  int tag = ((int)  tolua_tonumber(tolua_S,2,0));
+  bool enabled = ((bool)  tolua_toboolean(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetTriggerActivator'", NULL);
+#endif
+  {
+   self->SetTriggerActivator(tag,enabled);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetTriggerActivator'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: FindBodiesAt of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_FindBodiesAt00
+static int tolua_level_layer_LevelLayer_FindBodiesAt00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isusertype(tolua_S,2,"b2Vec2",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,3,&tolua_err) || !toluafix_istable(tolua_S,3,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isboolean(tolua_S,4,1,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,5,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  b2Vec2* pos = ((b2Vec2*)  tolua_tousertype(tolua_S,2,0));
+  LUA_TABLE result = ( toluafix_totable(tolua_S,3,0));
+  bool sort_by_draw_order = ((bool)  tolua_toboolean(tolua_S,4,false));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'FindBodiesAt'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->FindBodiesAt(pos,result,sort_by_draw_order);
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'FindBodiesAt'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: QueryRegion of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_QueryRegion00
+static int tolua_level_layer_LevelLayer_QueryRegion00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     (tolua_isvaluenil(tolua_S,3,&tolua_err) || !toluafix_istable(tolua_S,3,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE regions = ( toluafix_totable(tolua_S,2,0));
+  LUA_TABLE results = ( toluafix_totable(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'QueryRegion'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->QueryRegion(regions,results);
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'QueryRegion'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: OverlapCircle of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_OverlapCircle00
+static int tolua_level_layer_LevelLayer_OverlapCircle00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     (tolua_isvaluenil(tolua_S,3,&tolua_err) || !toluafix_istable(tolua_S,3,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE circles = ( toluafix_totable(tolua_S,2,0));
+  LUA_TABLE results = ( toluafix_totable(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'OverlapCircle'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->OverlapCircle(circles,results);
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'OverlapCircle'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: RayCastBatch of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_RayCastBatch00
+static int tolua_level_layer_LevelLayer_RayCastBatch00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     (tolua_isvaluenil(tolua_S,3,&tolua_err) || !toluafix_istable(tolua_S,3,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE rays = ( toluafix_totable(tolua_S,2,0));
+  LUA_TABLE results = ( toluafix_totable(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'RayCastBatch'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->RayCastBatch(rays,results);
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'RayCastBatch'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: StartPreview of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_StartPreview00
+static int tolua_level_layer_LevelLayer_StartPreview00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,4,0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,5,&tolua_err) || !toluafix_isfunction(tolua_S,5,"LUA_FUNCTION",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,6,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE tags = ( toluafix_totable(tolua_S,2,0));
+  int steps = ((int)  tolua_tonumber(tolua_S,3,0));
+  int sample_interval = ((int)  tolua_tonumber(tolua_S,4,0));
+  LUA_FUNCTION handler = ( toluafix_ref_function(tolua_S,5,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'StartPreview'", NULL);
+#endif
+  {
+   bool tolua_ret = (bool)  self->StartPreview(tags,steps,sample_interval,handler);
+   tolua_pushboolean(tolua_S,(bool)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'StartPreview'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: CancelPreview of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_CancelPreview00
+static int tolua_level_layer_LevelLayer_CancelPreview00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'CancelPreview'", NULL);
 #endif
   {
-   self->LevelComplete();
+   self->CancelPreview();
   }
  }
  return 0;
 #ifndef TOLUA_RELEASE
  tolua_lerror:
- tolua_error(tolua_S,"#ferror in function 'LevelComplete'.",&tolua_err);
+ tolua_error(tolua_S,"#ferror in function 'CancelPreview'.",&tolua_err);
  return 0;
 #endif
 }
 #endif //#ifndef TOLUA_DISABLE
 
-/* method: ToggleDebug of class  LevelLayer */
-#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_ToggleDebug00
-static int tolua_level_layer_LevelLayer_ToggleDebug00(lua_State* tolua_S)
+/* method: GetStrokeBuilder of class  LevelLayer */
+#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_GetStrokeBuilder00
+static int tolua_level_layer_LevelLayer_GetStrokeBuilder00(lua_State* tolua_S)
 {
 #ifndef TOLUA_RELEASE
  tolua_Error tolua_err;
@@ -111,51 +1091,317 @@ static int tolua_level_layer_LevelLayer_ToggleDebug00(lua_State* tolua_S)
  {
   LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
 #ifndef TOLUA_RELEASE
-  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'ToggleDebug'", NULL);
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'GetStrokeBuilder'", NULL);
 #endif
   {
-   self->ToggleDebug();
+   StrokeBuilder* tolua_ret = (StrokeBuilder*)  self->GetStrokeBuilder();
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"StrokeBuilder");
   }
  }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'GetStrokeBuilder'.",&tolua_err);
  return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: create of class  PhysicsBodyNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_PhysicsBodyNode_create00
+static int tolua_level_layer_PhysicsBodyNode_create00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertable(tolua_S,1,"PhysicsBodyNode",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  {
+   PhysicsBodyNode* tolua_ret = (PhysicsBodyNode*)  PhysicsBodyNode::create();
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"PhysicsBodyNode");
+  }
+ }
+ return 1;
 #ifndef TOLUA_RELEASE
  tolua_lerror:
- tolua_error(tolua_S,"#ferror in function 'ToggleDebug'.",&tolua_err);
+ tolua_error(tolua_S,"#ferror in function 'create'.",&tolua_err);
  return 0;
 #endif
 }
 #endif //#ifndef TOLUA_DISABLE
 
-/* method: FindBodiesAt of class  LevelLayer */
-#ifndef TOLUA_DISABLE_tolua_level_layer_LevelLayer_FindBodiesAt00
-static int tolua_level_layer_LevelLayer_FindBodiesAt00(lua_State* tolua_S)
+/* method: create of class  StrokeBatchNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeBatchNode_create00
+static int tolua_level_layer_StrokeBatchNode_create00(lua_State* tolua_S)
 {
 #ifndef TOLUA_RELEASE
  tolua_Error tolua_err;
  if (
-     !tolua_isusertype(tolua_S,1,"LevelLayer",0,&tolua_err) ||
-     !tolua_isusertype(tolua_S,2,"b2Vec2",0,&tolua_err) ||
-     (tolua_isvaluenil(tolua_S,3,&tolua_err) || !toluafix_isfunction(tolua_S,3,"LUA_FUNCTION",0,&tolua_err)) ||
+     !tolua_isusertable(tolua_S,1,"StrokeBatchNode",0,&tolua_err) ||
+     !tolua_isstring(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  const char* image = ((const char*)  tolua_tostring(tolua_S,2,0));
+  {
+   StrokeBatchNode* tolua_ret = (StrokeBatchNode*)  StrokeBatchNode::create(image);
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"StrokeBatchNode");
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'create'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: getTexture of class  StrokeBatchNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeBatchNode_getTexture00
+static int tolua_level_layer_StrokeBatchNode_getTexture00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBatchNode",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBatchNode* self = (StrokeBatchNode*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'getTexture'", NULL);
+#endif
+  {
+   CCTexture2D* tolua_ret = (CCTexture2D*)  self->getTexture();
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"CCTexture2D");
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'getTexture'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: create of class  StrokeNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeNode_create00
+static int tolua_level_layer_StrokeNode_create00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertable(tolua_S,1,"StrokeNode",0,&tolua_err) ||
+     !tolua_isusertype(tolua_S,2,"StrokeBatchNode",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
      !tolua_isnoobj(tolua_S,4,&tolua_err)
  )
   goto tolua_lerror;
  else
 #endif
  {
-  LevelLayer* self = (LevelLayer*)  tolua_tousertype(tolua_S,1,0);
-  b2Vec2* pos = ((b2Vec2*)  tolua_tousertype(tolua_S,2,0));
-  LUA_FUNCTION callback = ( toluafix_ref_function(tolua_S,3,0));
+  StrokeBatchNode* batch = ((StrokeBatchNode*)  tolua_tousertype(tolua_S,2,0));
+  float half_width = ((float)  tolua_tonumber(tolua_S,3,0));
+  {
+   StrokeNode* tolua_ret = (StrokeNode*)  StrokeNode::create(batch,half_width);
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"StrokeNode");
+  }
+ }
+ return 1;
 #ifndef TOLUA_RELEASE
-  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'FindBodiesAt'", NULL);
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'create'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: MoveTo of class  StrokeNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeNode_MoveTo00
+static int tolua_level_layer_StrokeNode_MoveTo00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeNode",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,4,&tolua_err) || !tolua_isusertype(tolua_S,4,"const ccColor3B",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,5,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeNode* self = (StrokeNode*)  tolua_tousertype(tolua_S,1,0);
+  float x = ((float)  tolua_tonumber(tolua_S,2,0));
+  float y = ((float)  tolua_tonumber(tolua_S,3,0));
+  const ccColor3B* color = ((const ccColor3B*)  tolua_tousertype(tolua_S,4,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'MoveTo'", NULL);
 #endif
   {
-   self->FindBodiesAt(pos,callback);
+   self->MoveTo(x,y,*color);
   }
  }
  return 0;
 #ifndef TOLUA_RELEASE
  tolua_lerror:
- tolua_error(tolua_S,"#ferror in function 'FindBodiesAt'.",&tolua_err);
+ tolua_error(tolua_S,"#ferror in function 'MoveTo'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: LineTo of class  StrokeNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeNode_LineTo00
+static int tolua_level_layer_StrokeNode_LineTo00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeNode",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,4,&tolua_err) || !tolua_isusertype(tolua_S,4,"const ccColor3B",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,5,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeNode* self = (StrokeNode*)  tolua_tousertype(tolua_S,1,0);
+  float x = ((float)  tolua_tonumber(tolua_S,2,0));
+  float y = ((float)  tolua_tonumber(tolua_S,3,0));
+  const ccColor3B* color = ((const ccColor3B*)  tolua_tousertype(tolua_S,4,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'LineTo'", NULL);
+#endif
+  {
+   self->LineTo(x,y,*color);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'LineTo'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: AddLine of class  StrokeNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeNode_AddLine00
+static int tolua_level_layer_StrokeNode_AddLine00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeNode",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,4,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,5,0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,6,&tolua_err) || !tolua_isusertype(tolua_S,6,"const ccColor3B",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,7,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeNode* self = (StrokeNode*)  tolua_tousertype(tolua_S,1,0);
+  float x1 = ((float)  tolua_tonumber(tolua_S,2,0));
+  float y1 = ((float)  tolua_tonumber(tolua_S,3,0));
+  float x2 = ((float)  tolua_tonumber(tolua_S,4,0));
+  float y2 = ((float)  tolua_tonumber(tolua_S,5,0));
+  const ccColor3B* color = ((const ccColor3B*)  tolua_tousertype(tolua_S,6,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'AddLine'", NULL);
+#endif
+  {
+   self->AddLine(x1,y1,x2,y2,*color);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'AddLine'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: Clear of class  StrokeNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeNode_Clear00
+static int tolua_level_layer_StrokeNode_Clear00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeNode",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeNode* self = (StrokeNode*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'Clear'", NULL);
+#endif
+  {
+   self->Clear();
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'Clear'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: GetPointCount of class  StrokeNode */
+#ifndef TOLUA_DISABLE_tolua_level_layer_StrokeNode_GetPointCount00
+static int tolua_level_layer_StrokeNode_GetPointCount00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeNode",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeNode* self = (StrokeNode*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'GetPointCount'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->GetPointCount();
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'GetPointCount'.",&tolua_err);
  return 0;
 #endif
 }
@@ -286,6 +1532,39 @@ static int tolua_level_layer_GameManager_LoadGame00(lua_State* tolua_S)
 }
 #endif //#ifndef TOLUA_DISABLE
 
+/* method: GetWorldPoolStats of class  GameManager */
+#ifndef TOLUA_DISABLE_tolua_level_layer_GameManager_GetWorldPoolStats00
+static int tolua_level_layer_GameManager_GetWorldPoolStats00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"GameManager",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !toluafix_istable(tolua_S,2,"LUA_TABLE",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  GameManager* self = (GameManager*)  tolua_tousertype(tolua_S,1,0);
+  LUA_TABLE stats = ( toluafix_totable(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'GetWorldPoolStats'", NULL);
+#endif
+  {
+   self->GetWorldPoolStats(stats);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'GetWorldPoolStats'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
 /* Open function */
 TOLUA_API int tolua_level_layer_open (lua_State* tolua_S)
 {
@@ -296,9 +1575,54 @@ TOLUA_API int tolua_level_layer_open (lua_State* tolua_S)
   tolua_cclass(tolua_S,"LevelLayer","LevelLayer","CCLayerColor",NULL);
   tolua_beginmodule(tolua_S,"LevelLayer");
    tolua_function(tolua_S,"GetWorld",tolua_level_layer_LevelLayer_GetWorld00);
+   tolua_function(tolua_S,"GetStaticBody",tolua_level_layer_LevelLayer_GetStaticBody00);
+   tolua_function(tolua_S,"SetFixtureTag",tolua_level_layer_LevelLayer_SetFixtureTag00);
+   tolua_function(tolua_S,"AddStaticEdges",tolua_level_layer_LevelLayer_AddStaticEdges00);
+   tolua_function(tolua_S,"AddStaticBoxes",tolua_level_layer_LevelLayer_AddStaticBoxes00);
    tolua_function(tolua_S,"LevelComplete",tolua_level_layer_LevelLayer_LevelComplete00);
    tolua_function(tolua_S,"ToggleDebug",tolua_level_layer_LevelLayer_ToggleDebug00);
+   tolua_function(tolua_S,"StepPhysics",tolua_level_layer_LevelLayer_StepPhysics00);
+   tolua_function(tolua_S,"ApplyPhysicsSettings",tolua_level_layer_LevelLayer_ApplyPhysicsSettings00);
+   tolua_function(tolua_S,"SetPhysicsRate",tolua_level_layer_LevelLayer_SetPhysicsRate00);
+   tolua_function(tolua_S,"SetPhysicsIterations",tolua_level_layer_LevelLayer_SetPhysicsIterations00);
+   tolua_function(tolua_S,"SetNativeStep",tolua_level_layer_LevelLayer_SetNativeStep00);
+   tolua_function(tolua_S,"SetPhysicsPaused",tolua_level_layer_LevelLayer_SetPhysicsPaused00);
+   tolua_function(tolua_S,"SetThreadedPhysics",tolua_level_layer_LevelLayer_SetThreadedPhysics00);
+   tolua_function(tolua_S,"SetPhysicsBudget",tolua_level_layer_LevelLayer_SetPhysicsBudget00);
+   tolua_function(tolua_S,"GetPhysicsQuality",tolua_level_layer_LevelLayer_GetPhysicsQuality00);
+   tolua_function(tolua_S,"SetPostStepHandler",tolua_level_layer_LevelLayer_SetPostStepHandler00);
+   tolua_function(tolua_S,"SetContactInterest",tolua_level_layer_LevelLayer_SetContactInterest00);
+   tolua_function(tolua_S,"SetGlobalContactInterest",tolua_level_layer_LevelLayer_SetGlobalContactInterest00);
+   tolua_function(tolua_S,"SetImpactThreshold",tolua_level_layer_LevelLayer_SetImpactThreshold00);
+   tolua_function(tolua_S,"SetGlobalImpactThreshold",tolua_level_layer_LevelLayer_SetGlobalImpactThreshold00);
+   tolua_function(tolua_S,"AddTrigger",tolua_level_layer_LevelLayer_AddTrigger00);
+   tolua_function(tolua_S,"RemoveTrigger",tolua_level_layer_LevelLayer_RemoveTrigger00);
+   tolua_function(tolua_S,"SetTriggerActivator",tolua_level_layer_LevelLayer_SetTriggerActivator00);
    tolua_function(tolua_S,"FindBodiesAt",tolua_level_layer_LevelLayer_FindBodiesAt00);
+   tolua_function(tolua_S,"QueryRegion",tolua_level_layer_LevelLayer_QueryRegion00);
+   tolua_function(tolua_S,"OverlapCircle",tolua_level_layer_LevelLayer_OverlapCircle00);
+   tolua_function(tolua_S,"RayCastBatch",tolua_level_layer_LevelLayer_RayCastBatch00);
+   tolua_function(tolua_S,"StartPreview",tolua_level_layer_LevelLayer_StartPreview00);
+   tolua_function(tolua_S,"CancelPreview",tolua_level_layer_LevelLayer_CancelPreview00);
+   tolua_function(tolua_S,"GetStrokeBuilder",tolua_level_layer_LevelLayer_GetStrokeBuilder00);
+  tolua_endmodule(tolua_S);
+  tolua_cclass(tolua_S,"PhysicsBodyNode","PhysicsBodyNode","CCPhysicsNode",NULL);
+  tolua_beginmodule(tolua_S,"PhysicsBodyNode");
+   tolua_function(tolua_S,"create",tolua_level_layer_PhysicsBodyNode_create00);
+  tolua_endmodule(tolua_S);
+  tolua_cclass(tolua_S,"StrokeBatchNode","StrokeBatchNode","CCNode",NULL);
+  tolua_beginmodule(tolua_S,"StrokeBatchNode");
+   tolua_function(tolua_S,"create",tolua_level_layer_StrokeBatchNode_create00);
+   tolua_function(tolua_S,"getTexture",tolua_level_layer_StrokeBatchNode_getTexture00);
+  tolua_endmodule(tolua_S);
+  tolua_cclass(tolua_S,"StrokeNode","StrokeNode","CCNode",NULL);
+  tolua_beginmodule(tolua_S,"StrokeNode");
+   tolua_function(tolua_S,"create",tolua_level_layer_StrokeNode_create00);
+   tolua_function(tolua_S,"MoveTo",tolua_level_layer_StrokeNode_MoveTo00);
+   tolua_function(tolua_S,"LineTo",tolua_level_layer_StrokeNode_LineTo00);
+   tolua_function(tolua_S,"AddLine",tolua_level_layer_StrokeNode_AddLine00);
+   tolua_function(tolua_S,"Clear",tolua_level_layer_StrokeNode_Clear00);
+   tolua_function(tolua_S,"GetPointCount",tolua_level_layer_StrokeNode_GetPointCount00);
   tolua_endmodule(tolua_S);
   tolua_cclass(tolua_S,"GameManager","GameManager","",NULL);
   tolua_beginmodule(tolua_S,"GameManager");
@@ -306,6 +1630,7 @@ TOLUA_API int tolua_level_layer_open (lua_State* tolua_S)
    tolua_function(tolua_S,"Restart",tolua_level_layer_GameManager_Restart00);
    tolua_function(tolua_S,"LoadLevel",tolua_level_layer_GameManager_LoadLevel00);
    tolua_function(tolua_S,"LoadGame",tolua_level_layer_GameManager_LoadGame00);
+   tolua_function(tolua_S,"GetWorldPoolStats",tolua_level_layer_GameManager_GetWorldPoolStats00);
   tolua_endmodule(tolua_S);
  tolua_endmodule(tolua_S);
  return 1;
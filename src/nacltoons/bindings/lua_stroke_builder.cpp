@@ -0,0 +1,434 @@
+/*
+** Lua binding: stroke_builder
+** Generated automatically by tolua++-1.0.93 on Wed May  8 17:00:28 2013.
+*/
+
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef __cplusplus
+#include "stdlib.h"
+#endif
+#include "string.h"
+
+#include "tolua++.h"
+
+/* Exported function */
+TOLUA_API int  tolua_stroke_builder_open (lua_State* tolua_S);
+
+#include "lua_stroke_builder.h"
+#include "stroke_builder.h"
+#include "physics_body_node.h"
+#include "stroke_batch_node.h"
+#include "tolua_fix.h"
+
+/* function to register type */
+static void tolua_reg_types (lua_State* tolua_S)
+{
+ tolua_usertype(tolua_S,"StrokeBuilder");
+ tolua_usertype(tolua_S,"StrokeBatchNode");
+ tolua_usertype(tolua_S,"ccColor3B");
+ tolua_usertype(tolua_S,"PhysicsBodyNode");
+}
+
+/* method: SetBrush of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_SetBrush00
+static int tolua_stroke_builder_StrokeBuilder_SetBrush00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isusertype(tolua_S,2,"StrokeBatchNode",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+  StrokeBatchNode* batch = ((StrokeBatchNode*)  tolua_tousertype(tolua_S,2,0));
+  float half_width = ((float)  tolua_tonumber(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetBrush'", NULL);
+#endif
+  {
+   self->SetBrush(batch,half_width);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetBrush'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetColor of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_SetColor00
+static int tolua_stroke_builder_StrokeBuilder_SetColor00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     (tolua_isvaluenil(tolua_S,2,&tolua_err) || !tolua_isusertype(tolua_S,2,"const ccColor3B",0,&tolua_err)) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+  const ccColor3B* color = ((const ccColor3B*)  tolua_tousertype(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetColor'", NULL);
+#endif
+  {
+   self->SetColor(*color);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetColor'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetSimplifyTolerance of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_SetSimplifyTolerance00
+static int tolua_stroke_builder_StrokeBuilder_SetSimplifyTolerance00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+  float tolerance = ((float)  tolua_tonumber(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetSimplifyTolerance'", NULL);
+#endif
+  {
+   self->SetSimplifyTolerance(tolerance);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetSimplifyTolerance'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: SetFinishMode of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_SetFinishMode00
+static int tolua_stroke_builder_StrokeBuilder_SetFinishMode00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,3,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+  int mode = ((int)  tolua_tonumber(tolua_S,2,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'SetFinishMode'", NULL);
+#endif
+  {
+   self->SetFinishMode(mode);
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'SetFinishMode'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: Begin of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_Begin00
+static int tolua_stroke_builder_StrokeBuilder_Begin00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,4,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,5,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+  int tag = ((int)  tolua_tonumber(tolua_S,2,0));
+  float x = ((float)  tolua_tonumber(tolua_S,3,0));
+  float y = ((float)  tolua_tonumber(tolua_S,4,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'Begin'", NULL);
+#endif
+  {
+   PhysicsBodyNode* tolua_ret = (PhysicsBodyNode*)  self->Begin(tag,x,y);
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"PhysicsBodyNode");
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'Begin'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: Append of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_Append00
+static int tolua_stroke_builder_StrokeBuilder_Append00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,2,0,&tolua_err) ||
+     !tolua_isnumber(tolua_S,3,0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,4,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+  float x = ((float)  tolua_tonumber(tolua_S,2,0));
+  float y = ((float)  tolua_tonumber(tolua_S,3,0));
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'Append'", NULL);
+#endif
+  {
+   bool tolua_ret = (bool)  self->Append(x,y);
+   tolua_pushboolean(tolua_S,(bool)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'Append'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: End of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_End00
+static int tolua_stroke_builder_StrokeBuilder_End00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'End'", NULL);
+#endif
+  {
+   PhysicsBodyNode* tolua_ret = (PhysicsBodyNode*)  self->End();
+    tolua_pushusertype(tolua_S,(void*)tolua_ret,"PhysicsBodyNode");
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'End'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: Cancel of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_Cancel00
+static int tolua_stroke_builder_StrokeBuilder_Cancel00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'Cancel'", NULL);
+#endif
+  {
+   self->Cancel();
+  }
+ }
+ return 0;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'Cancel'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: IsBuilding of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_IsBuilding00
+static int tolua_stroke_builder_StrokeBuilder_IsBuilding00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'IsBuilding'", NULL);
+#endif
+  {
+   bool tolua_ret = (bool)  self->IsBuilding();
+   tolua_pushboolean(tolua_S,(bool)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'IsBuilding'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: GetFixtureCount of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_GetFixtureCount00
+static int tolua_stroke_builder_StrokeBuilder_GetFixtureCount00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'GetFixtureCount'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->GetFixtureCount();
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'GetFixtureCount'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* method: GetUnsimplifiedFixtureCount of class  StrokeBuilder */
+#ifndef TOLUA_DISABLE_tolua_stroke_builder_StrokeBuilder_GetUnsimplifiedFixtureCount00
+static int tolua_stroke_builder_StrokeBuilder_GetUnsimplifiedFixtureCount00(lua_State* tolua_S)
+{
+#ifndef TOLUA_RELEASE
+ tolua_Error tolua_err;
+ if (
+     !tolua_isusertype(tolua_S,1,"StrokeBuilder",0,&tolua_err) ||
+     !tolua_isnoobj(tolua_S,2,&tolua_err)
+ )
+  goto tolua_lerror;
+ else
+#endif
+ {
+  StrokeBuilder* self = (StrokeBuilder*)  tolua_tousertype(tolua_S,1,0);
+#ifndef TOLUA_RELEASE
+  if (!self) tolua_error(tolua_S,"invalid 'self' in function 'GetUnsimplifiedFixtureCount'", NULL);
+#endif
+  {
+   int tolua_ret = (int)  self->GetUnsimplifiedFixtureCount();
+   tolua_pushnumber(tolua_S,(lua_Number)tolua_ret);
+  }
+ }
+ return 1;
+#ifndef TOLUA_RELEASE
+ tolua_lerror:
+ tolua_error(tolua_S,"#ferror in function 'GetUnsimplifiedFixtureCount'.",&tolua_err);
+ return 0;
+#endif
+}
+#endif //#ifndef TOLUA_DISABLE
+
+/* Open function */
+TOLUA_API int tolua_stroke_builder_open (lua_State* tolua_S)
+{
+ tolua_open(tolua_S);
+ tolua_reg_types(tolua_S);
+ tolua_module(tolua_S,NULL,0);
+ tolua_beginmodule(tolua_S,NULL);
+  tolua_cclass(tolua_S,"StrokeBuilder","StrokeBuilder","",NULL);
+  tolua_beginmodule(tolua_S,"StrokeBuilder");
+   tolua_constant(tolua_S,"FINISH_BOXES",StrokeBuilder::FINISH_BOXES);
+   tolua_constant(tolua_S,"FINISH_CONVEX",StrokeBuilder::FINISH_CONVEX);
+   tolua_function(tolua_S,"SetBrush",tolua_stroke_builder_StrokeBuilder_SetBrush00);
+   tolua_function(tolua_S,"SetColor",tolua_stroke_builder_StrokeBuilder_SetColor00);
+   tolua_function(tolua_S,"SetSimplifyTolerance",tolua_stroke_builder_StrokeBuilder_SetSimplifyTolerance00);
+   tolua_function(tolua_S,"SetFinishMode",tolua_stroke_builder_StrokeBuilder_SetFinishMode00);
+   tolua_function(tolua_S,"Begin",tolua_stroke_builder_StrokeBuilder_Begin00);
+   tolua_function(tolua_S,"Append",tolua_stroke_builder_StrokeBuilder_Append00);
+   tolua_function(tolua_S,"End",tolua_stroke_builder_StrokeBuilder_End00);
+   tolua_function(tolua_S,"Cancel",tolua_stroke_builder_StrokeBuilder_Cancel00);
+   tolua_function(tolua_S,"IsBuilding",tolua_stroke_builder_StrokeBuilder_IsBuilding00);
+   tolua_function(tolua_S,"GetFixtureCount",tolua_stroke_builder_StrokeBuilder_GetFixtureCount00);
+   tolua_function(tolua_S,"GetUnsimplifiedFixtureCount",tolua_stroke_builder_StrokeBuilder_GetUnsimplifiedFixtureCount00);
+  tolua_endmodule(tolua_S);
+ tolua_endmodule(tolua_S);
+ return 1;
+}
+
+
+#if defined(LUA_VERSION_NUM) && LUA_VERSION_NUM >= 501
+ TOLUA_API int luaopen_stroke_builder (lua_State* tolua_S) {
+ return tolua_stroke_builder_open(tolua_S);
+};
+#endif
+
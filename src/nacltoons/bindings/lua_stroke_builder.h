@@ -0,0 +1,8 @@
+/*
+** Lua binding: stroke_builder
+** Generated automatically by tolua++-1.0.93 on Wed May  8 17:00:28 2013.
+*/
+
+/* Exported function */
+TOLUA_API int  tolua_stroke_builder_open (lua_State* tolua_S);
+
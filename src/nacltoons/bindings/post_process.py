@@ -37,6 +37,7 @@ def main(args):
     toluafix_pushusertype_ccobject(tolua_S, nID, pLuaID, (void*)tolua_ret''')
 
     file_data = file_data.replace('*((LUA_FUNCTION*) ', '(')
+    file_data = file_data.replace('*((LUA_TABLE*) ', '(')
 
   with open(filename, 'w') as output_file:
     output_file.write(file_data)
@@ -7,6 +7,8 @@
 -- functions:
 --   - SetBrush
 --   - CreateShape
+--   - BeginStaticGeometry
+--   - EndStaticGeometry
 --   - CreateSprite
 --   - DrawStartPoint
 --   - DrawEndPoint
@@ -28,28 +30,39 @@ local drawing = {
 drawing.mode = drawing.MODE_FREEHAND
 
 -- Brush information (set by SetBrush)
-local brush_tex
+local brush_batch
 local brush_thickness
 
+-- Native builder for freehand strokes (set by SetBrush)
+local stroke_builder
+
 -- Constant for grouping physics bodies
 local MAIN_CATEGORY = 0x1
 local DRAWING_CATEGORY = 0x2
 
 -- Constants for tagging cocos nodes
-local TAG_BATCH_NODE = 0x1
+local TAG_STROKE_NODE = 0x1
 
--- Starting batch size for CCSpriteBatchNode.  We override
--- the default since we often have many sprites in each
--- node (each drawn element is it own batch node).
-local DEFAULT_BATCH_COUNT = 100
+-- Number of brush widths between the points of a drawn circle.
+local CIRCLE_POINT_SPACING = 1.5
 
 -- Local state for default touch handlers
 local current_shape = nil
+local preview = nil
 local current_tag = 99 -- util.tags.TAG_DYNAMIC_START
 local start_pos = nil
 local last_pos = nil
 local brush_color = ccc3(255, 100, 100)
 
+-- Edges waiting to be added to the static body (as a flat list of
+-- x1, y1, x2, y2, tag) between BeginStaticGeometry and EndStaticGeometry.
+local pending_edges = nil
+
+-- Lines waiting to be added to the static body in one go (as a flat
+-- list of x1, y1, x2, y2, half_thickness, tag) between
+-- BeginStaticGeometry and EndStaticGeometry.
+local pending_boxes = nil
+
 -- Callbacks that are registered for drawn objects.  The game
 -- can register its own callbacks here to add behavior for
 -- drawn objects.
@@ -64,21 +77,27 @@ local function b2VecFromLua(luapoint)
     return rtn
 end
 
-local function CreateBrushBatch(parent)
-    local node = CCSpriteBatchNode:createWithTexture(brush_tex, DEFAULT_BATCH_COUNT)
+--- Create the stroke node that draws the brush lines of a shape.  The
+-- strokes of all shapes are drawn together by the level's brush batch.
+local function CreateStroke(parent)
+    local node = StrokeNode:create(brush_batch, brush_thickness)
     assert(node)
-    parent:addChild(node, 1, TAG_BATCH_NODE)
+    parent:addChild(node, 1, TAG_STROKE_NODE)
     return node
 end
 
+local function GetStroke(parent)
+    local node = parent:getChildByTag(TAG_STROKE_NODE)
+    assert(node)
+    return tolua.cast(node, 'StrokeNode')
+end
+
 --- Create a fixed pivot point between the world and the given body.
 local function CreatePivot(anchor, body)
     local anchor_point = util.b2VecFromCocos(anchor)
 
-    -- create a new fixed body to pivot against
-    local ground_def = b2BodyDef:new_local()
-    ground_def.position = anchor_point
-    local ground_body = level_obj.world:CreateBody(ground_def);
+    -- All pivots share the level's static body as their ground.
+    local ground_body = level_obj.layer:GetStaticBody()
 
     -- create the pivot joint
     local joint_def = b2RevoluteJointDef:new_local()
@@ -86,6 +105,14 @@ local function CreatePivot(anchor, body)
     local joint = level_obj.world:CreateJoint(joint_def)
 end
 
+--- Add edges to the level's static body.  'edges' is a flat list of
+-- x1, y1, x2, y2, tag in box2d units.
+local function AddStaticEdges(edges)
+    if #edges > 0 then
+        level_obj.layer:AddStaticEdges(edges)
+    end
+end
+
 local function AddShapeToBody(body, shape, sensor)
     local fixture_def = b2FixtureDef:new_local()
     fixture_def.shape = shape
@@ -113,16 +140,49 @@ end
 
 -- Create and initialise a new invisible physics node.
 local function CreatePhysicsNode(location, dynamic, tag)
-    local node = CCPhysicsNode:create()
+    local node = PhysicsBodyNode:create()
     InitPhysicsNode(node, location, dynamic, tag)
     return node
 end
 
-local function DrawBrush(parent, location, color)
-    local child_sprite = CCSprite:createWithTexture(brush_tex)
-    child_sprite:setPosition(location)
-    child_sprite:setColor(color)
-    parent:addChild(child_sprite)
+--- Returns true if the geometry of the given shape can be merged
+-- into the level's shared static body.  Shapes are kept separate in
+-- the editor so that they can be moved.
+local function CanMergeShape(shape_def)
+    return not shape_def.dynamic and game_obj.game_mode ~= 'edit'
+end
+
+--- Create the node for a shape along with the body that its fixtures
+-- should be added to.  Shapes that can be merged get a plain node (for
+-- their sprites) and share the level's static body.  Returns the node,
+-- the body and whether the body is shared.
+local function CreateShapeNode(location, shape_def)
+    if not CanMergeShape(shape_def) then
+        local node = CreatePhysicsNode(location, shape_def.dynamic, shape_def.tag)
+        return node, node:getB2Body(), false
+    end
+
+    local node = CCNode:create()
+    node:setPosition(location)
+    node:setTag(shape_def.tag)
+    level_obj.layer:addChild(node, 1, shape_def.tag)
+    return node, level_obj.layer:GetStaticBody(), true
+end
+
+--- Create a trigger volume for an image shape.  Triggers live outside
+-- the box2d world, so the shape only gets a plain node for its sprite.
+-- Like merged shapes they are only used outside the editor.
+local function CreateTrigger(location, shape_def)
+    local node = CCNode:create()
+    node:setPosition(location)
+    node:setTag(shape_def.tag)
+    level_obj.layer:addChild(node, 1, shape_def.tag)
+
+    local sprite = CCSprite:create(game_obj.assets[shape_def.image])
+    node:addChild(sprite)
+    local radius = sprite:boundingBox().size.height/2 / util.PTM_RATIO
+    level_obj.layer:AddTrigger(shape_def.tag, util.b2VecFromCocos(location), radius)
+    return node
 end
 
 -- Add a new circle/sphere fixture to a body and return the new fixture
@@ -134,10 +194,13 @@ local function AddSphereToBody(body, location, radius, sensor)
     return AddShapeToBody(body, sphere, sensor)
 end
 
--- Add a new line/box fixture to a body and return the new fixture
-local function AddLineToShape(node, from, to, color, absolute)
+-- Add a new line/box fixture to a body and return the new fixture.
+-- The body is either the node's own body or the shared static body.
+-- 'merged_tag' is given for lines on the static body; between
+-- BeginStaticGeometry and EndStaticGeometry these are queued and added
+-- natively all at once, and no fixture is returned.
+local function AddLineToShape(node, body, from, to, color, absolute, merged_tag)
     -- calculate length and angle of line based on start and end points
-    local body = node:getB2Body()
     local length = ccpDistance(from, to);
     local dist_x = to.x - from.x
     local dist_y = to.y - from.y
@@ -147,31 +210,30 @@ local function AddLineToShape(node, from, to, color, absolute)
     if absolute then
        rel_start = node:convertToNodeSpace(from)
     end
-    local center = b2Vec2:new_local(util.ScreenToWorld(rel_start.x + dist_x/2),
-                                    util.ScreenToWorld(rel_start.y + dist_y/2))
-    local shape = b2PolygonShape:new_local()
-    local angle = math.atan2(dist_y, dist_x)
-    shape:SetAsBox(util.ScreenToWorld(length/2), util.ScreenToWorld(brush_thickness),
-                   center, angle)
-    local fixture = AddShapeToBody(body, shape, false)
-
-    -- Create sequence of sprite nodes as children
-    local dist = CCPointMake(dist_x, dist_y)
-    local num_children = math.ceil(length / brush_step)
-    local inc_x = dist_x / num_children
-    local inc_y = dist_y / num_children
-    local child_location = rel_start
-
-    util.Log('Create line at: rel=' .. util.PointToString(rel_start) .. ' len=' .. length .. ' num=' .. num_children)
-
-    local batch_node = node:getChildByTag(TAG_BATCH_NODE)
-    assert(batch_node)
-    for i = 1,num_children do
-        child_location.x = child_location.x + inc_x
-        child_location.y = child_location.y + inc_y
-        DrawBrush(batch_node, child_location, color)
+    local start_x = node:getPositionX() + rel_start.x
+    local start_y = node:getPositionY() + rel_start.y
+    local fixture = nil
+    if merged_tag and pending_boxes then
+        for _, value in ipairs({ util.ScreenToWorld(start_x), util.ScreenToWorld(start_y),
+                                 util.ScreenToWorld(start_x + dist_x), util.ScreenToWorld(start_y + dist_y),
+                                 util.ScreenToWorld(brush_thickness), merged_tag }) do
+            table.insert(pending_boxes, value)
+        end
+    else
+        local body_pos = body:GetPosition()
+        local center = b2Vec2:new_local(util.ScreenToWorld(start_x + dist_x/2) - body_pos.x,
+                                        util.ScreenToWorld(start_y + dist_y/2) - body_pos.y)
+        local shape = b2PolygonShape:new_local()
+        local angle = math.atan2(dist_y, dist_x)
+        shape:SetAsBox(util.ScreenToWorld(length/2), util.ScreenToWorld(brush_thickness),
+                       center, angle)
+        fixture = AddShapeToBody(body, shape, false)
     end
 
+    util.Log('Create line at: rel=' .. util.PointToString(rel_start) .. ' len=' .. length)
+
+    GetStroke(node):AddLine(rel_start.x, rel_start.y, rel_start.x + dist_x, rel_start.y + dist_y, color)
+
     return fixture
 end
 
@@ -193,17 +255,19 @@ local function MakeBodyDynamic(body)
     end
 end
 
---- Set brush texture for subsequent draw operations
+--- Set the brush batch (a StrokeBatchNode) for subsequent draw operations
 function drawing.SetBrush(brush)
-    -- calculate thickness based on brush sprite size
-    brush_tex = brush:getTexture()
-    local brush_size = brush_tex:getContentSizeInPixels()
+    -- calculate thickness based on brush texture size
+    brush_batch = brush
+    local brush_size = brush:getTexture():getContentSizeInPixels()
     brush_thickness = math.max(brush_size.height/2, brush_size.width/2)
-    brush_step = brush_thickness * 1.5
+    stroke_builder = level_obj.layer:GetStrokeBuilder()
+    stroke_builder:SetBrush(brush_batch, brush_thickness)
 end
 
 --- Create a physics sprite at a given location with a given image
-local function AddSpriteToShape(node, sprite_def, absolute)
+-- and return the fixture added for it to the given body.
+local function AddSpriteToShape(node, body, sprite_def, absolute)
     local pos = util.PointFromLua(sprite_def.pos, absolute)
     util.Log('Create sprite [tag=' .. sprite_def.tag .. ' image=' .. sprite_def.image .. ' absolute=' .. tostring(absolute) .. ']: ' ..
         util.PointToString(pos))
@@ -220,11 +284,14 @@ local function AddSpriteToShape(node, sprite_def, absolute)
     end
     sprite:setPosition(rel_pos)
     node:addChild(sprite)
-    AddSphereToBody(node:getB2Body(), world_pos, sprite:boundingBox().size.height/2, sprite_def.sensor)
-    return sprite
+    -- Triggers that can't be used (in the editor) become sensors instead.
+    local sensor = sprite_def.sensor or sprite_def.trigger
+    return AddSphereToBody(body, world_pos, sprite:boundingBox().size.height/2, sensor)
 end
 
-local function AddChildShape(shape, child_def, absolute)
+--- Add a child (line or image) to a shape and return its fixture, if
+-- it was created right away.
+local function AddChildShape(shape, body, child_def, absolute, merged)
     if child_def.color then
         color = ccc3(child_def.color[1], child_def.color[2], child_def.color[3])
     else
@@ -234,9 +301,9 @@ local function AddChildShape(shape, child_def, absolute)
     if child_def.type == 'line' then
         local start = util.PointFromLua(child_def.start, absolute)
         local finish = util.PointFromLua(child_def.finish, absolute)
-        AddLineToShape(shape, start, finish, color, absolute)
+        return AddLineToShape(shape, body, start, finish, color, absolute, merged and child_def.tag)
     elseif child_def.type == 'image' then
-        AddSpriteToShape(shape, child_def, absolute)
+        return AddSpriteToShape(shape, body, child_def, absolute)
     else
         assert(false, 'invalid shape type: ' .. shape_def.type)
     end
@@ -248,40 +315,67 @@ end
 function drawing.CreateShape(shape_def)
     local shape = nil
 
+    -- Fixtures added to the shared static body are tagged individually
+    -- so that contacts and queries still report the shape's tag.
+    local function TagFixture(fixture, merged)
+        if merged and fixture then
+            level_obj.layer:SetFixtureTag(fixture, shape_def.tag)
+        end
+    end
+
     if shape_def.type == 'compound' then
         local pos = util.PointFromLua(shape_def.pos)
-        shape = CreatePhysicsNode(pos, shape_def.dynamic, shape_def.tag)
-        CreateBrushBatch(shape)
+        local body, merged
+        shape, body, merged = CreateShapeNode(pos, shape_def)
+        CreateStroke(shape)
         if shape_def.children then
             for _, child_def in ipairs(shape_def.children) do
                 child_def.tag = shape_def.tag
-                child = AddChildShape(shape, child_def, false)
+                TagFixture(AddChildShape(shape, body, child_def, false, merged), merged)
             end
         end
     elseif shape_def.type == 'line' then
         local pos = util.PointFromLua(shape_def.start)
-        shape = CreatePhysicsNode(pos, shape_def.dynamic, shape_def.tag)
-        CreateBrushBatch(shape)
-        AddChildShape(shape, shape_def, true)
+        local body, merged
+        shape, body, merged = CreateShapeNode(pos, shape_def)
+        CreateStroke(shape)
+        TagFixture(AddChildShape(shape, body, shape_def, true, merged), merged)
     elseif shape_def.type == 'edge' then
-        local body_def = b2BodyDef:new_local()
-        local body = level_obj.world:CreateBody(body_def)
-        local b2shape = b2EdgeShape:new_local()
+        -- Edges have no node so they are always merged, even in the editor.
         local start = b2VecFromLua(shape_def.start)
         local finish = b2VecFromLua(shape_def.finish)
         util.Log('Create edge from: ' .. util.VecToString(start) .. ' to: ' .. util.VecToString(finish))
-        b2shape:Set(start, finish)
-        body:CreateFixture(b2shape, 0)
+        local edges = pending_edges or {}
+        for _, value in ipairs({ start.x, start.y, finish.x, finish.y, shape_def.tag or 0 }) do
+            table.insert(edges, value)
+        end
+        if not pending_edges then
+            AddStaticEdges(edges)
+        end
         return
     elseif shape_def.type == 'image' then
         local pos = util.PointFromLua(shape_def.pos)
+        if shape_def.trigger and CanMergeShape(shape_def) then
+            return CreateTrigger(pos, shape_def)
+        end
         shape = CreatePhysicsNode(pos, shape_def.dynamic, shape_def.tag)
-        AddChildShape(shape, shape_def, true)
+        AddChildShape(shape, shape:getB2Body(), shape_def, true)
     else
         assert(false, 'invalid shape type: ' .. shape_def.type)
     end
 
-    if shape_def.anchor then
+    if shape_def.trigger_activator then
+        level_obj.layer:SetTriggerActivator(shape_def.tag, true)
+    end
+
+    -- Fast moving shapes (such as the ball) can ask for continuous
+    -- collision against other dynamic bodies too.
+    if shape_def.bullet and shape_def.dynamic then
+        shape:getB2Body():SetBullet(true)
+    end
+
+    -- Merged shapes are already fixed to the static body.
+    if shape_def.anchor and not CanMergeShape(shape_def) then
         local body = shape:getB2Body()
         local anchor = util.PointFromLua(shape_def.anchor)
         CreatePivot(anchor, body)
@@ -290,6 +384,27 @@ function drawing.CreateShape(shape_def)
     return shape
 end
 
+--- Start collecting the edges and lines of shapes created with
+-- CreateShape so that EndStaticGeometry can add them to the static
+-- body in bulk, joining connected edges into chains.
+function drawing.BeginStaticGeometry()
+    pending_edges = {}
+    pending_boxes = {}
+end
+
+--- Add the edges and lines collected since BeginStaticGeometry to the
+-- level.
+function drawing.EndStaticGeometry()
+    local edges = pending_edges
+    local boxes = pending_boxes
+    pending_edges = nil
+    pending_boxes = nil
+    AddStaticEdges(edges)
+    if #boxes > 0 then
+        level_obj.layer:AddStaticBoxes(boxes)
+    end
+end
+
 --- Create a single circlular point with the brush.
 -- This is used to start shapes that the user draws.  The returned
 -- node is the an invisible node that acts as the physics objects.
@@ -297,12 +412,10 @@ end
 function drawing.DrawStartPoint(location, color, tag, dynamic)
     -- Add invisibe physics node
     local node = CreatePhysicsNode(location, dynamic, tag)
-    CreateBrushBatch(node)
 
-    -- Add visible sprite
-    local sprite = CCSprite:createWithTexture(brush_tex)
-    sprite:setColor(color)
-    node:addChild(sprite)
+    -- Add visible brush stroke
+    local stroke = CreateStroke(node)
+    stroke:MoveTo(0, 0, color)
 
     -- Add collision info
     local fixture = AddSphereToBody(node:getB2Body(), location, brush_thickness, false)
@@ -311,25 +424,30 @@ function drawing.DrawStartPoint(location, color, tag, dynamic)
     return node
 end
 
---- Create a circle composed of brush sprites backed by a single box2d
--- circle fixture.
-function drawing.DrawCircle(center, radius, color, tag)
-    -- Create the initial (invisible) node at the center
-    -- and then attach a sequence of visible child sprites
-    local node = CreatePhysicsNode(center, true, tag)
-    local batch_node = CreateBrushBatch(node)
-
+--- Add a circle around the origin of a stroke node, with its outer
+-- edge at the given radius.  Returns the number of points used.
+local function AddCircleToStroke(stroke, radius, color)
     local inner_radius = math.max(radius - brush_thickness, 1)
     local circumference = 2 * math.pi * inner_radius
-    local num_sprites = math.max(circumference / brush_step, 1)
-    local angle_delta = 2 * math.pi / num_sprites
-
-    util.Log('drawing circle: radius=' .. math.floor(radius) .. ' sprites=' .. math.floor(num_sprites))
-    for angle = 0, 2 * math.pi, angle_delta do
-        x = inner_radius * math.cos(angle)
-        y = inner_radius * math.sin(angle)
-        DrawBrush(batch_node, ccp(x, y), color)
+    local num_points = math.max(math.ceil(circumference / (brush_thickness * CIRCLE_POINT_SPACING)), 8)
+    local angle_delta = 2 * math.pi / num_points
+
+    stroke:MoveTo(inner_radius, 0, color)
+    for i = 1, num_points do
+        local angle = i * angle_delta
+        stroke:LineTo(inner_radius * math.cos(angle), inner_radius * math.sin(angle), color)
     end
+    return num_points
+end
+
+--- Create a circle drawn as a closed brush stroke backed by a single
+-- box2d circle fixture.
+function drawing.DrawCircle(center, radius, color, tag)
+    -- Create the initial (invisible) node at the center
+    -- and then attach a visible stroke around it
+    local node = CreatePhysicsNode(center, true, tag)
+    local num_points = AddCircleToStroke(CreateStroke(node), radius, color)
+    util.Log('drawing circle: radius=' .. math.floor(radius) .. ' points=' .. num_points)
 
     -- Create the box2d physics body to match the sphere.
     local fixture = AddSphereToBody(node:getB2Body(), center, radius, false)
@@ -338,11 +456,9 @@ function drawing.DrawCircle(center, radius, color, tag)
 end
 
 function drawing.DrawEndPoint(node, location, color)
-    -- Add visible sprite
-    local child_sprite = CCSprite:createWithTexture(brush_tex)
-    child_sprite:setPosition(node:convertToNodeSpace(location))
-    child_sprite:setColor(color)
-    node:addChild(child_sprite)
+    -- Finish the visible stroke at the end point
+    local end_point = node:convertToNodeSpace(location)
+    GetStroke(node):LineTo(end_point.x, end_point.y, color)
 
     -- Add collision info
     local body = node:getB2Body()
@@ -351,7 +467,7 @@ function drawing.DrawEndPoint(node, location, color)
 end
 
 function drawing.AddLineToShape(sprite, from, to, color)
-    fixture = AddLineToShape(sprite, from, to, color, true)
+    fixture = AddLineToShape(sprite, sprite:getB2Body(), from, to, color, true)
     SetCategory(fixture, DRAWING_CATEGORY)
 end
 
@@ -381,11 +497,18 @@ function drawing.OnTouchBegan(x, y)
         script = drawing.handlers,
     }
 
-    if drawing.mode == drawing.MODE_FREEHAND or drawing.mode == drawing.MODE_LINE then
-        -- create initial sphere to represent start of shape
-        shape.node = drawing.DrawStartPoint(start_pos, brush_color, current_tag)
-    elseif drawing.mode == drawing.MODE_CIRCLE then
-        shape.node = drawing.DrawCircle(start_pos, 1, brush_color, current_tag)
+    if drawing.mode == drawing.MODE_FREEHAND then
+        -- freehand strokes are built natively, one call per touch sample
+        stroke_builder:SetColor(brush_color)
+        shape.node = stroke_builder:Begin(current_tag, x, y)
+    elseif drawing.mode == drawing.MODE_LINE or drawing.mode == drawing.MODE_CIRCLE then
+        -- Lines and circles are previewed with a plain stroke node that
+        -- is redrawn in place as the touch moves.  The shape itself is
+        -- only created when the touch ends.
+        preview = StrokeNode:create(brush_batch, brush_thickness)
+        preview:setPosition(start_pos)
+        level_obj.layer:addChild(preview, 1)
+        drawing.UpdatePreview(x, y)
     else
         error('invalid drawing mode: ' .. tostring(drawing.mode))
     end
@@ -406,28 +529,41 @@ function drawing.DestroySprite(sprite)
    body:GetWorld():DestroyBody(body)
 end
 
+--- Abandon the shape being drawn, if any, and remove its nodes.  The
+-- shape's tag is left registered.
+function drawing.CancelTouch()
+    if preview then
+        preview:removeFromParentAndCleanup(true)
+        preview = nil
+    end
+    if stroke_builder then
+        stroke_builder:Cancel()
+    end
+    current_shape = nil
+end
+
 --- Sample OnTouchMoved for drawing-based games.  For bespoke drawing behaviour
 -- clone and modify this code.
 function drawing.OnTouchMoved(x, y)
-    new_pos = ccp(x, y)
     if drawing.mode == drawing.MODE_FREEHAND then
         -- Draw line segments as the touch moves
-        local length = ccpDistance(new_pos, last_pos);
-        if length > brush_thickness * 2 then
-            drawing.AddLineToShape(current_shape.node, last_pos, new_pos, brush_color)
-            last_pos = new_pos
-        end
-    elseif drawing.mode == drawing.MODE_LINE then
-        local tag = current_shape.node:getTag()
-        drawing.DestroySprite(current_shape.node)
+        stroke_builder:Append(x, y)
+        return
+    end
+
+    drawing.UpdatePreview(x, y)
+end
 
-        current_shape.node = drawing.DrawStartPoint(start_pos, brush_color, tag)
-        drawing.AddLineToShape(current_shape.node, start_pos, new_pos, brush_color)
+--- Redraw the preview of the line or circle being drawn so that it
+-- ends at (or passes through) the given point.
+function drawing.UpdatePreview(x, y)
+    local dx = x - start_pos.x
+    local dy = y - start_pos.y
+    preview:Clear()
+    if drawing.mode == drawing.MODE_LINE then
+        preview:AddLine(0, 0, dx, dy, brush_color)
     elseif drawing.mode == drawing.MODE_CIRCLE then
-        local tag = current_shape.node:getTag()
-        drawing.DestroySprite(current_shape.node)
-        radius = ccpDistance(start_pos, new_pos)
-        current_shape.node = drawing.DrawCircle(start_pos, radius, brush_color, tag)
+        AddCircleToStroke(preview, math.sqrt(dx * dx + dy * dy), brush_color)
     else
         error('invalid drawing mode: ' .. tostring(drawing.mode))
     end
@@ -439,20 +575,31 @@ function drawing.OnTouchEnded(x, y)
     -- Draw the final line segment and the end point of the line
 
     if drawing.mode == drawing.MODE_FREEHAND then
-        new_pos = ccp(x, y)
-        local length = ccpDistance(new_pos, last_pos);
-        if length > brush_thickness then
-            drawing.AddLineToShape(current_shape.node, last_pos, new_pos, brush_color)
-        end
-        drawing.DrawEndPoint(current_shape.node, new_pos, brush_color)
+        -- The builder also makes the body dynamic.
+        stroke_builder:Append(x, y)
+        stroke_builder:End()
+        util.Log('stroke fixtures: ' .. stroke_builder:GetUnsimplifiedFixtureCount() ..
+                 ' simplified to ' .. stroke_builder:GetFixtureCount())
     elseif drawing.mode == drawing.MODE_CIRCLE or drawing.mode == drawing.MODE_LINE then
-        --
+        -- Replace the preview with the real shape.
+        preview:removeFromParentAndCleanup(true)
+        preview = nil
+        local end_pos = ccp(x, y)
+        local tag = current_shape.tag
+        if drawing.mode == drawing.MODE_LINE then
+            current_shape.node = drawing.DrawStartPoint(start_pos, brush_color, tag)
+            if ccpDistance(start_pos, end_pos) > brush_thickness then
+                drawing.AddLineToShape(current_shape.node, start_pos, end_pos, brush_color)
+            end
+        else
+            local radius = ccpDistance(start_pos, end_pos)
+            current_shape.node = drawing.DrawCircle(start_pos, radius, brush_color, tag)
+        end
+        MakeBodyDynamic(current_shape.node:getB2Body())
     else
         error('invalid drawing mode: ' .. tostring(drawing.mode))
     end
 
-    MakeBodyDynamic(current_shape.node:getB2Body())
-
     local rtn = current_shape
     last_pos = nil
     start_pos = nil
@@ -11,8 +11,6 @@ local drawing = require 'drawing'
 local editor = {}
 
 local MENU_DRAW_ORDER = 3
-local VELOCITY_ITERATIONS = 8
-local POS_ITERATIONS = 1
 
 local actions = { ADD_SHAPE = 1, MOVE = 2 }
 local undo_buffer = {}
@@ -25,18 +23,12 @@ local function Set(list)
 end
 
 local function SerializeLevel()
-    local ignore_keys = Set({ 'tag', 'script', 'tag_map', 'tag_list', 'object_map' })
+    local ignore_keys = Set({ 'tag', 'script', 'tag_map', 'tag_list', 'object_map', 'physics_settings', 'snapshot_tags', 'level_number' })
     local key_map = { tag_str = 'tag', script_name = 'script' }
     local output = util.TableToYaml(level_obj, ignore_keys, key_map)
     return '# Automatically generated by editor.lua\n\n' .. output
 end
 
-function editor.Update(delta)
-    if level_obj.run_physics then
-      level_obj.world:Step(delta, VELOCITY_ITERATIONS, POS_ITERATIONS)
-    end
-end
-
 function editor.OnTouchBegan(x, y, tapcount)
     if drawing.IsDrawing() then
         return false
@@ -158,6 +150,7 @@ end
 
 local function ToggleRun()
     level_obj.run_physics = not level_obj.run_physics
+    level_obj.layer:SetPhysicsPaused(not level_obj.run_physics)
 end
 
 local function HandleRestart()
@@ -168,9 +161,18 @@ local function HandleExit()
     CCDirector:sharedDirector():popScene()
 end
 
+function editor.RestartLevel(level_number)
+    -- Objects referenced by the undo buffers may no longer exist.
+    undo_buffer = {}
+    redo_buffer = {}
+    level_obj.run_physics = false
+    level_obj.layer:SetPhysicsPaused(true)
+end
+
 function editor.StartLevel(level_number)
     -- Create a textual menu it its own layer as a sibling of the LevelLayer
     level_obj.run_physics = false
+    level_obj.layer:SetPhysicsPaused(true)
     menu_def = {
         font_size = 24,
         align = 'Left',
@@ -3,16 +3,28 @@
 -- found in the LICENSE file.
 
 -- Main entry points of the lua game engine.
--- Currently this file exposed 3 functions to the C++ code during
--- startup:
+-- Currently this file exposed 7 functions to the C++ code.  They are
+-- looked up once each time a game is loaded (see lua_callbacks.cc) so
+-- redefining them later has no effect:
 --  - LoadGame  (called my game_manager to load game.def)
 --  - LoadLevel  (called by level_layer to load a level)
+--  - OnContactEvents  (called by level_layer once per frame)
+--  - PrepareRestartLevel  (called by level_layer before restarting in
+--    place)
+--  - RestartLevel  (called by level_layer when restarting in place)
+--  - OnPhysicsQualityChanged  (called by level_layer when the physics
+--    governor changes the simulation quality)
+--  - OnContactImpulses  (called by level_layer once per frame with any
+--    hard impacts)
 --
--- There are also 3 functions for which the game can define its own
+-- There are also 6 functions for which the game can define its own
 -- handlers:
 --  - OnContactBegan
 --  - OnContactEnded
+--  - OnImpact
 --  - StartLevel
+--  - RestartLevel
+--  - OnPhysicsQualityChanged
 
 local drawing = require 'drawing'
 local path = require 'path'
@@ -24,6 +36,26 @@ local validate = require 'validate'
 -- and easier to read.
 local Log = util.Log
 
+-- Physics settings used for any values not given in the 'physics'
+-- section of game.def or the level def.
+local DEFAULT_PHYSICS = {
+    velocity_iterations = 8,
+    position_iterations = 1,
+    native_step = true,
+    threaded = false,
+    step_budget = 0,
+    gravity = { 0, -9.8 },
+    allow_sleeping = true,
+    continuous = true,
+    warm_starting = true,
+    sub_stepping = false,
+    rate = 60,
+    max_steps = 5,
+    -- Smallest impulse reported to OnImpact handlers, unless the object
+    -- def sets its own 'impact_threshold'.
+    impact_threshold = 1.0,
+}
+
 -- The currently loaded game (set by LoadGame)
 game_obj = nil
 
@@ -49,6 +81,25 @@ local function LoadGameDef(filename)
     return game
 end
 
+--- Tell the LevelLayer which contact events the given object has
+-- handlers for so that other contacts are filtered out before they
+-- reach lua.
+local function UpdateContactInterest(object)
+    local script = object.script
+    if type(script) ~= 'table' then
+        return
+    end
+    level_obj.layer:SetContactInterest(object.tag,
+                                       script.OnContactBegan ~= nil,
+                                       script.OnContactEnded ~= nil)
+    local threshold = 0
+    if script.OnImpact then
+        local physics = level_obj.physics_settings or DEFAULT_PHYSICS
+        threshold = object.impact_threshold or physics.impact_threshold
+    end
+    level_obj.layer:SetImpactThreshold(object.tag, threshold)
+end
+
 function RegisterObject(object, tag, tag_str)
     level_obj.tag_list[tag] = tag_str
     assert(level_obj.object_map[tag] == nil, 'object_map already contains ' .. tag)
@@ -58,10 +109,21 @@ function RegisterObject(object, tag, tag_str)
         assert(level_obj.tag_map[tag_str] == nil, 'duplicate object tag: ' .. tag_str)
         level_obj.tag_map[tag_str] = tag
     end
+    UpdateContactInterest(object)
     if not tag_str then tag_str = '' end
     Log('object registered: ' .. tag .. " = '" .. tag_str .. "'")
 end
 
+--- Forget about an object that has been removed from the level.
+local function UnregisterObject(tag)
+    local tag_str = level_obj.tag_list[tag]
+    if tag_str and level_obj.tag_map[tag_str] == tag then
+        level_obj.tag_map[tag_str] = nil
+    end
+    level_obj.tag_list[tag] = nil
+    level_obj.object_map[tag] = nil
+end
+
 local function RegisterObjectDef(object)
     local new_tag = #level_obj.tag_list + 1
     if object.tag then
@@ -79,7 +141,12 @@ local function LoadScript(obj_def)
         Log('loading object script: ' .. obj_def.script)
         local script = path.join(game_obj.root, obj_def.script)
         obj_def.script = dofile(script)
-        if obj_def.script and obj_def.script.Update then
+        if obj_def.tag then
+            UpdateContactInterest(obj_def)
+        end
+        -- The level script's Update is called from GameUpdate rather than
+        -- being scheduled on the layer itself.
+        if obj_def.script and obj_def.script.Update and obj_def ~= level_obj then
             obj_def.node:scheduleUpdateWithPriorityLua(obj_def.script.Update, 0)
         end
     end
@@ -123,7 +190,32 @@ local function LevelInit()
     level_obj.object_map = {}
 end
 
+--- Return the physics settings for the current level.  Values in the
+-- level def take precedence over those in game.def.
+local function GetPhysicsSettings()
+    local settings = {}
+    for key, value in pairs(DEFAULT_PHYSICS) do
+        settings[key] = value
+    end
+    for _, def in ipairs({ game_obj.physics or {}, level_obj.physics or {} }) do
+        for key, value in pairs(def) do
+            settings[key] = value
+        end
+    end
+    return settings
+end
+
+--- Called by the LevelLayer each frame after the physics step.
 local function GameUpdate(delta)
+    -- A contact handler may already have completed the level this frame.
+    if not level_obj then
+        return
+    end
+    local physics = level_obj.physics_settings
+    if not physics.native_step then
+        level_obj.layer:StepPhysics(delta, physics.velocity_iterations,
+                                    physics.position_iterations)
+    end
     if game_obj.script.Update then
         game_obj.script.Update(delta)
     end
@@ -132,6 +224,14 @@ local function GameUpdate(delta)
     end
 end
 
+--- Returns true if GameUpdate has anything to do for the current level.
+local function NeedsGameUpdate()
+    local level_script = level_obj.script
+    return not level_obj.physics_settings.native_step or
+           game_obj.script.Update ~= nil or
+           (type(level_script) == 'table' and level_script.Update ~= nil)
+end
+
 --- Load the given level of the given game
 -- @param layer The level to populate with game objects
 -- @param level_number The level to load
@@ -149,10 +249,15 @@ function LoadLevel(layer, level_number)
     level_obj.layer = layer
     level_obj.world = layer:GetWorld()
 
+    local physics = GetPhysicsSettings()
+    level_obj.physics_settings = physics
+    layer:ApplyPhysicsSettings(physics)
+
     local assets = game_obj.assets
 
-    -- Load brush image
-    level_obj.brush = CCSpriteBatchNode:create(assets.brush_image, 500)
+    -- Load brush image.  All brush strokes in the level are drawn by
+    -- this one node.
+    level_obj.brush = StrokeBatchNode:create(assets.brush_image)
     layer:addChild(level_obj.brush, 1)
     drawing.SetBrush(level_obj.brush)
 
@@ -183,19 +288,78 @@ function LoadLevel(layer, level_number)
     end
 
     if level_obj.shapes then
+        drawing.BeginStaticGeometry()
         LoadShapes(level_obj.shapes)
+        drawing.EndStaticGeometry()
     end
 
     -- Load custom level script
     level_obj.node = level_obj.layer
     LoadScript(level_obj)
 
-    if game_obj.script.Update then
-        level_obj.layer:scheduleUpdateWithPriorityLua(GameUpdate, 0)
+    -- Handlers in the game or level script want to hear about all contacts
+    local function HasGlobalHandler(name)
+        local level_script = level_obj.script
+        return game_obj.script[name] ~= nil or
+               (type(level_script) == 'table' and level_script[name] ~= nil)
+    end
+    layer:SetGlobalContactInterest(HasGlobalHandler('OnContactBegan'),
+                                   HasGlobalHandler('OnContactEnded'))
+    if HasGlobalHandler('OnImpact') then
+        layer:SetGlobalImpactThreshold(physics.impact_threshold)
+    else
+        layer:SetGlobalImpactThreshold(0)
+    end
+
+    -- Only cross into lua each frame when something needs it.
+    if NeedsGameUpdate() then
+        level_obj.layer:SetPostStepHandler(GameUpdate)
     end
 
     layer:registerScriptTouchHandler(touch_handler.TouchHandler)
+    level_obj.level_number = level_number
     StartLevel(level_number)
+
+    -- Report how big the pooled physics worlds have grown.
+    local stats = {}
+    GameManager:sharedManager():GetWorldPoolStats(stats)
+    Log(string.format('world pool: %d created, %d reused, max bodies=%d joints=%d contacts=%d proxies=%d',
+                      stats.worlds_created, stats.worlds_reused, stats.max_bodies,
+                      stats.max_joints, stats.max_contacts, stats.max_proxies))
+
+    -- The LevelLayer takes a snapshot of the level once this function
+    -- returns.  Remember which objects existed at that point so that
+    -- RestartLevel can forget any created later.
+    level_obj.snapshot_tags = {}
+    for tag, _ in pairs(level_obj.object_map) do
+        level_obj.snapshot_tags[tag] = true
+    end
+end
+
+--- Called by the LevelLayer before it restores the level to its
+-- snapshot.  Returns false, without changing anything, if the game
+-- can't restart in place, in which case the level is reloaded from
+-- scratch.  Otherwise any shape being drawn is abandoned, since the
+-- restore removes its nodes.
+function PrepareRestartLevel()
+    if level_obj == nil or not game_obj.script.RestartLevel then
+        return false
+    end
+    drawing.CancelTouch()
+    return true
+end
+
+--- Called by the LevelLayer after it has restored the level to its
+-- snapshot, if PrepareRestartLevel agreed to it.
+function RestartLevel()
+    for tag, _ in pairs(level_obj.object_map) do
+        if not level_obj.snapshot_tags[tag] then
+            UnregisterObject(tag)
+        end
+    end
+
+    game_obj.script.RestartLevel(level_obj.level_number)
+    return true
 end
 
 local function ApplyToAllChildren(node, callback)
@@ -219,7 +383,7 @@ function LevelComplete()
     level_obj = nil
 end
 
-local function CallCollisionHandler(tag1, tag2, handler_name)
+local function CallCollisionHandler(tag1, tag2, handler_name, ...)
     local object1 = level_obj.object_map[tag1]
     local object2 = level_obj.object_map[tag2]
 
@@ -231,28 +395,67 @@ local function CallCollisionHandler(tag1, tag2, handler_name)
 
     -- call the individual object's collision handler, if any
     if object1.script and object1.script[handler_name] then
-        object1.script[handler_name](object1, object2)
+        object1.script[handler_name](object1, object2, ...)
     end
     if object2.script and object2.script[handler_name] then
-        object2.script[handler_name](object2, object1)
+        object2.script[handler_name](object2, object1, ...)
     end
 
     if level_obj.script and level_obj.script[handler_name] then
-        level_obj.script[handler_name](object1, object2)
+        level_obj.script[handler_name](object1, object2, ...)
     end
 
     -- call the game's collision handler, if any
     if game_obj.script[handler_name] then
-        game_obj.script[handler_name](object1, object2)
+        game_obj.script[handler_name](object1, object2, ...)
     end
 end
 
-function OnContactBegan(tag1, tag2)
-    CallCollisionHandler(tag1, tag2, 'OnContactBegan')
+--- Called by the LevelLayer once per frame with all the contacts that
+-- occured during the physics step.  'events' is a flat array of
+-- (tag1, tag2, began) triples.
+function OnContactEvents(events)
+    for i = 1, #events, 3 do
+        -- A handler may have completed the level.
+        if level_obj == nil then
+            return
+        end
+        if events[i + 2] then
+            CallCollisionHandler(events[i], events[i + 1], 'OnContactBegan')
+        else
+            CallCollisionHandler(events[i], events[i + 1], 'OnContactEnded')
+        end
+    end
 end
 
-function OnContactEnded(tag1, tag2)
-    CallCollisionHandler(tag1, tag2, 'OnContactEnded')
+--- Called by the LevelLayer once per frame with the hardest impact
+-- between each pair of objects that hit each other at least as hard as
+-- their impact threshold.  'impulses' is a flat array of
+-- (tag1, tag2, impulse) triples.
+function OnContactImpulses(impulses)
+    for i = 1, #impulses, 3 do
+        -- A handler may have completed the level.
+        if level_obj == nil then
+            return
+        end
+        CallCollisionHandler(impulses[i], impulses[i + 1], 'OnImpact', impulses[i + 2])
+    end
+end
+
+--- Called by the LevelLayer when the physics governor changes the
+-- quality of the simulation to keep within the 'step_budget'.  Level 0
+-- is full quality.
+function OnPhysicsQualityChanged(level, velocity_iterations, position_iterations, continuous, average_ms)
+    Log('physics quality changed to ' .. level .. ' (iterations=' ..
+        velocity_iterations .. '/' .. position_iterations .. ' ccd=' ..
+        tostring(continuous) .. ' step time=' .. average_ms .. 'ms)')
+    local handler_name = 'OnPhysicsQualityChanged'
+    if level_obj and type(level_obj.script) == 'table' and level_obj.script[handler_name] then
+        level_obj.script[handler_name](level, continuous)
+    end
+    if game_obj.script[handler_name] then
+        game_obj.script[handler_name](level, continuous)
+    end
 end
 
 function StartLevel(level_number)
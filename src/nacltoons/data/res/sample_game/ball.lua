@@ -9,6 +9,9 @@
 --   OnTouchEnded(self, x, y)
 --   OnContactBegan(self, other)
 --   OnContactEnded(self, other)
+--   OnImpact(self, other, impulse) - called at most once per frame for
+--                                    contacts at least as hard as the
+--                                    object's impact_threshold
 --
 -- As well as arguments recieved this script has access
 -- to global game variables:
@@ -39,4 +42,8 @@ function handlers.OnContactEnded(self, other)
     util.Log('ball contact ended: ' .. other.tag_str)
 end
 
+function handlers.OnImpact(self, other, impulse)
+    util.Log('ball hit ' .. other.tag_str .. ': ' .. impulse)
+end
+
 return handlers
@@ -3,6 +3,7 @@
 -- occur:
 --   StartGame
 --   StartLevel
+--   RestartLevel
 --   OnTouchBegan(x, y, tapcount) -- return true to accept touch
 --   OnTouchMoved(x, y, tapcount)
 --   OnTouchEnded(x, y)
@@ -28,8 +29,6 @@ local handlers = {}
 local MENU_DRAW_ORDER = 3
 local FONT_NAME = 'Arial.ttf'
 local FONT_SIZE = 32
-local VELOCITY_ITERATIONS = 8
-local POS_ITERATIONS = 1
 
 
 --- Menu callback
@@ -56,12 +55,10 @@ local function PositionTimer(timer)
     timer:setPosition(ccp(xpos, ypos))
 end
 
---- Game behaviour callback.  Called every frame with the time delta
--- in seconds since the previous frame.
+--- Game behaviour callback.  Called every frame, after the physics
+-- world has been stepped, with the time delta in seconds since the
+-- previous frame.
 function handlers.Update(delta)
-    -- Update box2d world
-    level_obj.world:Step(delta, VELOCITY_ITERATIONS, POS_ITERATIONS)
-
     -- Check for timeout
     local state = level_obj.game_state
     state.time_remaining = state.time_remaining - delta
@@ -78,7 +75,15 @@ function handlers.Update(delta)
     end
 end
 
---- Game behaviour callback.  Called when a level is started/restarted.
+local function InitGameState()
+    level_obj.game_state = {
+        goal_reached = false,
+        time_remaining = 30,
+        stars_collected = { },
+    }
+end
+
+--- Game behaviour callback.  Called when a level is started.
 -- This function sets up level-specific game state, and adds any UI
 -- needed for the level.  In this case we add a menu layer to the scene
 -- that is drawn on top of the LevelLayer.
@@ -86,12 +91,7 @@ function handlers.StartLevel(level_number)
     util.Log('game.lua: StartLevel: ' .. level_number)
     drawing.handlers.OnTouchBegan = drawn_object_handlers
 
-    -- Initialize game state
-    level_obj.game_state = {
-        goal_reached = false,
-        time_remaining = 30,
-        stars_collected = { },
-    }
+    InitGameState()
 
     -- Lookup some tags that are used later in the collution code.
     level_obj.ball_tag = level_obj.tag_map['BALL']
@@ -120,15 +120,21 @@ function handlers.StartLevel(level_number)
     PositionTimer(level_obj.time_display)
 end
 
+--- Game behaviour callback.  Called when a level is restarted in place,
+-- after all the objects in the level have been reset.  The menu and the
+-- time display created by StartLevel still exist at this point.
+function handlers.RestartLevel(level_number)
+    util.Log('game.lua: RestartLevel: ' .. level_number)
+    InitGameState()
+    level_obj.time_display:setString("--")
+    PositionTimer(level_obj.time_display)
+end
+
 --- Remove a shape that was previously draw by this drawing module.
 function drawing.RemoveShape(tag)
-    local sprite = level_obj.brush:getChildByTag(tag)
-    -- Remove the box2d body
-    sprite = tolua.cast(sprite, "CCPhysicsSprite")
-    local body = sprite:getB2Body()
-    level_obj.world:DestroyBody(body)
-    -- Remove the sprite from the brush (its parent)
-    level_obj.brush:removeChild(sprite, true)
+    local node = level_obj.layer:getChildByTag(tag)
+    -- Remove the node (and its stroke) along with its box2d body
+    drawing.DestroySprite(tolua.cast(node, "PhysicsBodyNode"))
 end
 
 local last_drawn_shape = nil
@@ -230,9 +236,4 @@ function handlers.OnContactBegan(object1, object2)
     end
 end
 
---- Called when two tagged objects stop colliding (in the box2d world).
-function handlers.OnContactEnded(object1, object2)
-    -- util.Log('game.lua: OnContactEnded')
-end
-
 return handlers
@@ -17,30 +17,19 @@ local touch_state = {
     is_object = false,
 }
 
-local function FindTaggedBodiesAt(x, y)
+--- Return a list of the objects whose bodies are at the given location,
+-- with the top most object first.
+local function FindObjectsAt(x, y)
     local b2pos = util.b2VecFromCocos(ccp(x, y))
-    local found_bodies = {}
-    local found_something = false
-    local function handler(body)
-        found_something = true
-        local tag = body:GetUserData()
-        if tag ~= 0 then
-            -- FindBodiesAt can report the same bodies more than
-            -- once since it reports the body for each fixture that
-            -- exists at a given point, so filter out duplicates here.
-            if not found_bodies[tag] then
-                util.Log("found body.. " .. tag)
-                assert(level_obj.object_map[tag])
-                found_bodies[tag] = level_obj.object_map[tag]
-            end
-        end
-    end
-
-    level_obj.layer:FindBodiesAt(b2pos, handler)
-    if found_something and #found_bodies == 0 then
-        util.Log("Found untagged bodies")
+    local tags = {}
+    local count = level_obj.layer:FindBodiesAt(b2pos, tags, true)
+    local objects = {}
+    for i = 1, count do
+        local obj_def = level_obj.object_map[tags[i]]
+        assert(obj_def, 'unknown body tag: ' .. tags[i])
+        objects[i] = obj_def
     end
-    return found_bodies
+    return objects
 end
 
 local lasttap_time = 0
@@ -71,9 +60,9 @@ local function OnTouchBegan(x, y, touchid)
     tapcount = lasttap_count
     util.Log('tapcount ' .. tapcount)
 
-    local objects = FindTaggedBodiesAt(x, y, 0x1)
+    local objects = FindObjectsAt(x, y)
 
-    for _, obj_def in pairs(objects) do
+    for _, obj_def in ipairs(objects) do
         if obj_def.script and obj_def.script.OnTouchBegan then
             if obj_def.script.OnTouchBegan(obj_def, x, y, tapcount) then
                 touch_state.touchid = touchid
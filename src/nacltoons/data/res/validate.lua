@@ -39,6 +39,45 @@ local function CheckValidKeys(filename, object, valid_keys)
     end
 end
 
+local function CheckValueType(filename, object, key, type_name)
+    if object[key] ~= nil and type(object[key]) ~= type_name then
+        Error(filename, 'invalid value for ' .. key .. ': expected ' .. type_name)
+    end
+end
+
+--- Check the 'physics' section of a game or level def.
+local function CheckPhysics(filename, physics)
+    if type(physics) ~= 'table' then
+        return Error(filename, "'physics' must be a table")
+    end
+    CheckValidKeys(filename, physics, { 'velocity_iterations', 'position_iterations', 'native_step', 'threaded', 'step_budget',
+                                        'gravity', 'allow_sleeping', 'continuous', 'warm_starting', 'sub_stepping',
+                                        'rate', 'max_steps', 'impact_threshold' })
+    CheckValueType(filename, physics, 'velocity_iterations', 'number')
+    CheckValueType(filename, physics, 'position_iterations', 'number')
+    CheckValueType(filename, physics, 'native_step', 'boolean')
+    CheckValueType(filename, physics, 'threaded', 'boolean')
+    CheckValueType(filename, physics, 'step_budget', 'number')
+    CheckValueType(filename, physics, 'allow_sleeping', 'boolean')
+    CheckValueType(filename, physics, 'continuous', 'boolean')
+    CheckValueType(filename, physics, 'warm_starting', 'boolean')
+    CheckValueType(filename, physics, 'sub_stepping', 'boolean')
+    CheckValueType(filename, physics, 'rate', 'number')
+    CheckValueType(filename, physics, 'max_steps', 'number')
+    CheckValueType(filename, physics, 'impact_threshold', 'number')
+    local gravity = physics.gravity
+    if gravity ~= nil and (type(gravity) ~= 'table' or #gravity ~= 2 or
+                           type(gravity[1]) ~= 'number' or type(gravity[2]) ~= 'number') then
+        Error(filename, 'invalid value for gravity: expected [ x, y ]')
+    end
+    if physics.rate ~= nil and physics.rate <= 0 then
+        Error(filename, 'invalid value for rate: must be greater than 0')
+    end
+    if physics.max_steps ~= nil and physics.max_steps < 1 then
+        Error(filename, 'invalid value for max_steps: must be at least 1')
+    end
+end
+
 local function CheckRequiredKeys(filename, object, required_keys, name)
     for _, required in ipairs(required_keys) do
         if object[required] == nil then
@@ -62,7 +101,11 @@ validate.ValidateGameDef = function(filename, gamedef)
     end
 
 
-    CheckValidKeys(filename, gamedef, { 'assets', 'script', 'levels', 'root' })
+    CheckValidKeys(filename, gamedef, { 'assets', 'script', 'levels', 'root', 'physics' })
+    if gamedef.physics then
+        CheckPhysics(filename, gamedef.physics)
+    end
+
     if not gamedef.assets then
         return
     end
@@ -93,10 +136,14 @@ validate.ValidateLevelDef = function(filename, gamedef, leveldef)
         return Err("file does not evaluate to an object of type 'table'")
     end
 
-    CheckValidKeys(filename, leveldef, { 'num_stars', 'shapes', 'script' })
+    CheckValidKeys(filename, leveldef, { 'num_stars', 'shapes', 'script', 'physics' })
+    if leveldef.physics then
+        CheckPhysics(filename, leveldef.physics)
+    end
 
     if leveldef.shapes then
-        local valid_keys = { 'script', 'pos', 'children', 'sensor', 'image', 'start', 'finish', 'color', 'type', 'anchor', 'tag', 'dynamic' }
+        local valid_keys = { 'script', 'pos', 'children', 'sensor', 'image', 'start', 'finish', 'color', 'type', 'anchor', 'tag', 'dynamic', 'bullet',
+                             'trigger', 'trigger_activator', 'impact_threshold' }
         local valid_types = { 'compound', 'line', 'edge', 'image' }
         local required_keys = { 'type' }
 
@@ -107,6 +154,13 @@ validate.ValidateLevelDef = function(filename, gamedef, leveldef)
                 else
                     CheckValidKeys(filename, shape, valid_keys)
                     CheckRequiredKeys(filename, shape, required_keys, 'shape')
+                    CheckValueType(filename, shape, 'bullet', 'boolean')
+                    CheckValueType(filename, shape, 'trigger', 'boolean')
+                    CheckValueType(filename, shape, 'trigger_activator', 'boolean')
+                    CheckValueType(filename, shape, 'impact_threshold', 'number')
+                    if shape.trigger and shape.type ~= 'image' then
+                        Err('only image shapes can be triggers')
+                    end
                     if not ListContains(valid_types, shape.type) then
                         Err('invalid shape type: ' .. shape.type)
                     end
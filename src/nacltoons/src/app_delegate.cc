@@ -7,6 +7,7 @@
 #include "LuaBox2D.h"
 #include "LuaCocos2dExtensions.h"
 #include "lua_level_layer.h"
+#include "lua_stroke_builder.h"
 #include "game_manager.h"
 
 extern "C" {
@@ -45,6 +46,8 @@ bool AppDelegate::applicationDidFinishLaunching() {
   tolua_LuaBox2D_open(lua_state);
   // add LevelLayer bindings
   tolua_level_layer_open(lua_state);
+  // add StrokeBuilder bindings
+  tolua_stroke_builder_open(lua_state);
   // add cocos2dx extensions bindings
   tolua_extensions_open(lua_state);
   // add yaml bindings
@@ -0,0 +1,134 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef BODY_PAIR_TABLE_H_
+#define BODY_PAIR_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Small open addressing hash table mapping an unordered pair of (non-zero)
+ * body tags to a value of type T.  Used by the LevelLayer to aggregate
+ * per-fixture contacts into per-body contacts.  Entries are removed with
+ * backward shift deletion so no tombstones are needed.
+ */
+template <typename T>
+class BodyPairTable {
+ public:
+  BodyPairTable() : count_(0) {
+    slots_.resize(kInitialSize);
+  }
+
+  // Return a reference to the value for the given pair, inserting a
+  // default constructed value if the pair is not present.
+  T& operator()(int tag1, int tag2) {
+    if ((count_ + 1) * 2 > slots_.size())
+      Grow();
+    uint64_t key = MakeKey(tag1, tag2);
+    size_t i = FindSlot(key);
+    if (slots_[i].key != key) {
+      slots_[i].key = key;
+      slots_[i].value = T();
+      count_++;
+    }
+    return slots_[i].value;
+  }
+
+  // Return the value for the given pair or NULL if it is not present.
+  T* Find(int tag1, int tag2) {
+    uint64_t key = MakeKey(tag1, tag2);
+    size_t i = FindSlot(key);
+    if (slots_[i].key != key)
+      return NULL;
+    return &slots_[i].value;
+  }
+
+  void Remove(int tag1, int tag2) {
+    uint64_t key = MakeKey(tag1, tag2);
+    size_t i = FindSlot(key);
+    if (slots_[i].key != key)
+      return;
+
+    // Shift back any following entries in the same probe sequence
+    // that would no longer be reachable.
+    size_t mask = slots_.size() - 1;
+    size_t j = i;
+    while (true) {
+      j = (j + 1) & mask;
+      if (slots_[j].key == kEmpty)
+        break;
+      size_t home = Hash(slots_[j].key) & mask;
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        slots_[i] = slots_[j];
+        i = j;
+      }
+    }
+    slots_[i].key = kEmpty;
+    count_--;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < slots_.size(); i++)
+      slots_[i].key = kEmpty;
+    count_ = 0;
+  }
+
+  size_t size() const { return count_; }
+
+ private:
+  enum { kInitialSize = 64 };
+  static const uint64_t kEmpty = 0;
+
+  struct Slot {
+    Slot() : key(kEmpty), value() {}
+    uint64_t key;
+    T value;
+  };
+
+  static uint64_t MakeKey(int tag1, int tag2) {
+    uint32_t a = tag1;
+    uint32_t b = tag2;
+    if (a > b) {
+      uint32_t tmp = a;
+      a = b;
+      b = tmp;
+    }
+    return ((uint64_t)a << 32) | b;
+  }
+
+  static size_t Hash(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key;
+  }
+
+  // Return the slot containing key, or the empty slot where it
+  // would be inserted.
+  size_t FindSlot(uint64_t key) const {
+    size_t mask = slots_.size() - 1;
+    size_t i = Hash(key) & mask;
+    while (slots_[i].key != kEmpty && slots_[i].key != key)
+      i = (i + 1) & mask;
+    return i;
+  }
+
+  void Grow() {
+    std::vector<Slot> old_slots;
+    old_slots.swap(slots_);
+    slots_.resize(old_slots.size() * 2);
+    for (size_t i = 0; i < old_slots.size(); i++) {
+      if (old_slots[i].key == kEmpty)
+        continue;
+      size_t j = FindSlot(old_slots[i].key);
+      slots_[j] = old_slots[i];
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t count_;
+};
+
+#endif  // BODY_PAIR_TABLE_H_
@@ -24,6 +24,17 @@ void GameManager::CreateLevel()
 
 void GameManager::Restart()
 {
+  // Try to restart the level in place, which is much faster than
+  // recreating it.
+  LevelLayer* level =
+      static_cast<LevelLayer*>(scene_->getChildByTag(TAG_LAYER_LEVEL));
+  if (level && level->RestoreSnapshot()) {
+    CCNode* overlay = scene_->getChildByTag(TAG_LAYER_OVERLAY);
+    if (overlay)
+      scene_->removeChild(overlay, true);
+    return;
+  }
+
   scene_->removeAllChildren();
   // Recreate the level
   CreateLevel();
@@ -36,12 +47,17 @@ bool GameManager::LoadGame(const char* folder) {
   CCLuaStack* lua_stack = engine->getLuaStack();
   assert(lua_stack);
 
+  // (Re)load references to the global lua functions called by the
+  // engine, which are defined in loader.lua.
+  lua_callbacks_.Refresh(lua_stack);
+  if (!lua_callbacks_.Push(LUA_CALLBACK_LOAD_GAME))
+    return false;
+
   CCLog("running LoadGame on stack: %p", lua_stack);
   lua_stack->pushString(folder);
 
   // Call 'LoadGame' with single argument pushed above.
-  // 'LoadGame' is a global symbol defined in loader.lua.
-  int rtn = lua_stack->executeFunctionByName("LoadGame", 1);
+  int rtn = lua_callbacks_.Call(1);
   assert(rtn != -1);
   if (rtn != 1)
     return false;
@@ -63,6 +79,25 @@ void GameManager::LoadLevel(int level_number)
   director->pushScene(transition);
 }
 
+static void SetField(lua_State* state, int table, const char* key,
+                     int value) {
+  lua_pushinteger(state, value);
+  lua_setfield(state, table, key);
+}
+
+void GameManager::GetWorldPoolStats(int stats) {
+  CCScriptEngineManager* manager = CCScriptEngineManager::sharedManager();
+  CCLuaEngine* engine = (CCLuaEngine*)manager->getScriptEngine();
+  lua_State* state = engine->getLuaStack()->getLuaState();
+  SetField(state, stats, "worlds_created", world_pool_.GetWorldsCreated());
+  SetField(state, stats, "worlds_reused", world_pool_.GetWorldsReused());
+  SetField(state, stats, "max_bodies", world_pool_.GetMaxBodies());
+  SetField(state, stats, "max_joints", world_pool_.GetMaxJoints());
+  SetField(state, stats, "max_contacts", world_pool_.GetMaxContacts());
+  SetField(state, stats, "max_proxies", world_pool_.GetMaxProxies());
+  SetField(state, stats, "max_tree_height", world_pool_.GetMaxTreeHeight());
+}
+
 void GameManager::GameOver(bool success) {
   CCSize visible_size = CCDirector::sharedDirector()->getVisibleSize();
 
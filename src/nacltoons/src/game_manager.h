@@ -6,6 +6,8 @@
 #define GAME_MANAGER_H_
 
 #include "cocos2d.h"
+#include "lua_callbacks.h"
+#include "world_pool.h"
 
 /**
  * Tags used by the GameManager to identify scene elements. Actual values
@@ -29,11 +31,18 @@ class GameManager {
   void LoadLevel(int level_number);
   static GameManager* sharedManager();
   bool LoadGame(const char* folder);
+  LuaCallbacks* GetLuaCallbacks() { return &lua_callbacks_; }
+  WorldPool* GetWorldPool() { return &world_pool_; }
+  // Fill in the given lua table with the world pool's counters and
+  // high-water marks (see WorldPool).
+  void GetWorldPoolStats(LUA_TABLE stats);
  private:
   void CreateLevel();
   GameManager() : level_number_(0), scene_(NULL) {}
   int level_number_;
   CCScene* scene_;
+  LuaCallbacks lua_callbacks_;
+  WorldPool world_pool_;
 };
 
 #endif  // GAME_MANAGER_H_
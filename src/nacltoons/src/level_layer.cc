@@ -3,10 +3,15 @@
 // found in the LICENSE file.
 
 #include <stdint.h>
+#include <math.h>
+#include <algorithm>
 
 #include "level_layer.h"
 #include "app_delegate.h"
 #include "game_manager.h"
+#include "physics_body_node.h"
+#include "stroke_builder.h"
+#include "world_preview.h"
 
 #include "physics_nodes/CCPhysicsSprite.h"
 #include "CCLuaEngine.h"
@@ -19,38 +24,288 @@ extern "C" {
 #include "tolua_fix.h"
 }
 
-// Pixels-to-meters ratio for converting screen coordinates
-// to Box2D "meters".
-#define PTM_RATIO 32
+// Default physics step rate (in Hz) and the maximum number of steps
+// run per frame when catching up.
+#define DEFAULT_PHYSICS_RATE 60
+#define DEFAULT_MAX_PHYSICS_STEPS 5
+
+// Default iteration counts for the native physics step.
+#define DEFAULT_VELOCITY_ITERATIONS 8
+#define DEFAULT_POSITION_ITERATIONS 1
+
+// Number of contact events to reserve space for up front.
+#define CONTACT_EVENT_RESERVE 256
+
+// Size, in meters, of the cells of the trigger grid.
+#define TRIGGER_CELL_SIZE 2.0f
+
+// Flags for LevelLayer::contact_interest_.
+#define CONTACT_INTEREST_BEGAN 1
+#define CONTACT_INTEREST_ENDED 2
 
 USING_NS_CC_EXT;
 
-class Box2DCallbackHandler : public b2QueryCallback
+// Base class for world queries which collect the tags of all bodies
+// that have a fixture overlapping some region.
+class TagQueryCallback : public b2QueryCallback
 {
  public:
-  Box2DCallbackHandler(b2Vec2* test_point, CCLuaStack* lua_stack,
-                       int lua_handler) :
-     test_point_(*test_point),
-     lua_handler_(lua_handler),
-     lua_stack_(lua_stack) {}
+  explicit TagQueryCallback(std::vector<int>* tags) : tags_(tags) {}
 
   // Called by box2d when doing AABB testing to find bodies.
   bool ReportFixture(b2Fixture* fixture)
   {
-    if (fixture->TestPoint(test_point_)) {
-      b2Body* body = fixture->GetBody();
-      lua_stack_->pushUserType(body, "b2Body");
-      lua_stack_->executeFunctionByHandler(lua_handler_, 1);
-    }
+    int tag = LevelLayer::TagForFixture(fixture);
+    if (!tag)
+      return true;
+
+    // Bodies made of many fixtures can be reported many times.
+    if (std::find(tags_->begin(), tags_->end(), tag) != tags_->end())
+      return true;
+
+    if (Overlaps(fixture))
+      tags_->push_back(tag);
 
     return true; // keep looking
   }
 
  protected:
-  // Used by b2QueryCallback to find bodies as a given location
+  // Returns true if the fixture is within the query region.
+  virtual bool Overlaps(b2Fixture* fixture) = 0;
+
+  std::vector<int>* tags_;
+};
+
+class PointQueryCallback : public TagQueryCallback
+{
+ public:
+  PointQueryCallback(const b2Vec2& test_point, std::vector<int>* tags) :
+     TagQueryCallback(tags),
+     test_point_(test_point) {}
+
+ protected:
+  bool Overlaps(b2Fixture* fixture)
+  {
+    return fixture->TestPoint(test_point_);
+  }
+
   b2Vec2 test_point_;
-  int lua_handler_;
-  CCLuaStack* lua_stack_;
+};
+
+class AABBQueryCallback : public TagQueryCallback
+{
+ public:
+  AABBQueryCallback(const b2AABB& aabb, std::vector<int>* tags) :
+     TagQueryCallback(tags),
+     aabb_(aabb) {}
+
+ protected:
+  bool Overlaps(b2Fixture* fixture)
+  {
+    int32 child_count = fixture->GetShape()->GetChildCount();
+    for (int32 i = 0; i < child_count; i++) {
+      if (b2TestOverlap(aabb_, fixture->GetAABB(i)))
+        return true;
+    }
+    return false;
+  }
+
+  b2AABB aabb_;
+};
+
+class CircleQueryCallback : public TagQueryCallback
+{
+ public:
+  CircleQueryCallback(const b2Vec2& center, float radius,
+                      std::vector<int>* tags) :
+     TagQueryCallback(tags) {
+    circle_.m_p = center;
+    circle_.m_radius = radius;
+    identity_.SetIdentity();
+  }
+
+ protected:
+  bool Overlaps(b2Fixture* fixture)
+  {
+    const b2Shape* shape = fixture->GetShape();
+    const b2Transform& transform = fixture->GetBody()->GetTransform();
+    int32 child_count = shape->GetChildCount();
+    for (int32 i = 0; i < child_count; i++) {
+      if (b2TestOverlap(&circle_, 0, shape, i, identity_, transform))
+        return true;
+    }
+    return false;
+  }
+
+  b2CircleShape circle_;
+  b2Transform identity_;
+};
+
+// Finds the closest non-sensor fixture along a ray.
+class ClosestRayCastCallback : public b2RayCastCallback
+{
+ public:
+  ClosestRayCastCallback() : fixture_(NULL), fraction_(1.0f) {}
+
+  float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point,
+                        const b2Vec2& normal, float32 fraction)
+  {
+    if (fixture->IsSensor())
+      return -1; // ignore this fixture and continue
+
+    fixture_ = fixture;
+    point_ = point;
+    normal_ = normal;
+    fraction_ = fraction;
+    return fraction; // clip the ray to this point
+  }
+
+  b2Fixture* fixture_;
+  b2Vec2 point_;
+  b2Vec2 normal_;
+  float32 fraction_;
+};
+
+// Helpers for reading and writing the flat lua arrays used by the
+// query methods.
+static float GetArrayNumber(lua_State* state, int table, int index)
+{
+  lua_rawgeti(state, table, index);
+  float value = lua_tonumber(state, -1);
+  lua_pop(state, 1);
+  return value;
+}
+
+static void SetArrayNumber(lua_State* state, int table, int index,
+                           lua_Number value)
+{
+  lua_pushnumber(state, value);
+  lua_rawseti(state, table, index);
+}
+
+// Helpers for reading optional named fields from a lua table.  When the
+// field is missing (or has the wrong type) the given default is returned.
+static float GetFieldNumber(lua_State* state, int table, const char* key,
+                            float default_value)
+{
+  lua_getfield(state, table, key);
+  float value = lua_isnumber(state, -1) ? lua_tonumber(state, -1)
+                                        : default_value;
+  lua_pop(state, 1);
+  return value;
+}
+
+static bool GetFieldBool(lua_State* state, int table, const char* key,
+                         bool default_value)
+{
+  lua_getfield(state, table, key);
+  bool value = lua_isboolean(state, -1) ? lua_toboolean(state, -1)
+                                        : default_value;
+  lua_pop(state, 1);
+  return value;
+}
+
+// Orders tags such that the child node drawn last (on top) comes first.
+class DrawOrderCompare
+{
+ public:
+  explicit DrawOrderCompare(CCNode* parent) : parent_(parent) {}
+
+  bool operator()(int tag1, int tag2) const
+  {
+    CCNode* node1 = parent_->getChildByTag(tag1);
+    CCNode* node2 = parent_->getChildByTag(tag2);
+    if (!node1 || !node2)
+      return node1 != NULL;
+    if (node1->getZOrder() != node2->getZOrder())
+      return node1->getZOrder() > node2->getZOrder();
+    return node1->getOrderOfArrival() > node2->getOrderOfArrival();
+  }
+
+ private:
+  CCNode* parent_;
+};
+
+// Edge of the level's static geometry, as passed to AddStaticEdges.
+struct StaticEdge {
+  b2Vec2 start;
+  b2Vec2 finish;
+  int tag;
+};
+
+static bool SamePoint(const b2Vec2& point1, const b2Vec2& point2)
+{
+  return b2DistanceSquared(point1, point2) <= b2_linearSlop * b2_linearSlop;
+}
+
+// Find an unused edge with the given tag that has an end at 'point' and
+// return the point at its other end.
+static bool FindNextEdge(const std::vector<StaticEdge>& edges, int tag,
+                         const b2Vec2& point, std::vector<bool>* used,
+                         b2Vec2* next)
+{
+  for (size_t i = 0; i < edges.size(); i++) {
+    if ((*used)[i] || edges[i].tag != tag)
+      continue;
+    if (SamePoint(edges[i].start, point)) {
+      *next = edges[i].finish;
+    } else if (SamePoint(edges[i].finish, point)) {
+      *next = edges[i].start;
+    } else {
+      continue;
+    }
+    (*used)[i] = true;
+    return true;
+  }
+  return false;
+}
+
+// Collect the vertices of the chain of connected edges that contains
+// edges[first], marking the edges as used.  Returns true if the chain
+// forms a closed loop, in which case the first vertex is not repeated
+// at the end.
+static bool BuildChain(const std::vector<StaticEdge>& edges, int first,
+                       std::vector<bool>* used, std::vector<b2Vec2>* chain)
+{
+  int tag = edges[first].tag;
+  (*used)[first] = true;
+  chain->clear();
+  chain->push_back(edges[first].start);
+  chain->push_back(edges[first].finish);
+
+  // Walk forwards from the end of the first edge.
+  b2Vec2 next;
+  while (FindNextEdge(edges, tag, chain->back(), used, &next)) {
+    if (SamePoint(next, chain->front()))
+      return chain->size() >= 3;
+    chain->push_back(next);
+  }
+
+  // Then backwards from its start.
+  std::vector<b2Vec2> head;
+  b2Vec2 point = chain->front();
+  while (FindNextEdge(edges, tag, point, used, &next)) {
+    head.push_back(next);
+    point = next;
+  }
+  chain->insert(chain->begin(), head.rbegin(), head.rend());
+  return false;
+}
+
+// Task which runs the pending physics steps of a LevelLayer.
+class PhysicsStepTask : public WorkerTask
+{
+ public:
+  explicit PhysicsStepTask(LevelLayer* layer) : layer_(layer) {}
+
+  void Run()
+  {
+    layer_->RunPhysicsSteps(layer_->pending_velocity_iterations_,
+                            layer_->pending_position_iterations_);
+  }
+
+ private:
+  LevelLayer* layer_;
 };
 
 bool LevelLayer::init() {
@@ -62,18 +317,95 @@ bool LevelLayer::init() {
 }
 
 bool LevelLayer::LoadLevel(int level_number) {
+  // Schedule the native update before loading the level so that
+  // the level's lua code is able to unschedule it.
+  scheduleUpdate();
+
   // Load level from lua file.
   LoadLua(level_number);
   CCLog("loaded level");
   setTouchEnabled(true);
+  snapshot_.Capture(box2d_world_, this);
   return true;
 }
 
-LevelLayer::LevelLayer() : debug_enabled_(false) {
+bool LevelLayer::RestoreSnapshot() {
+  if (level_complete_ || !snapshot_.CanRestore(box2d_world_))
+    return false;
+
+  // Lua is asked first so that nothing has changed if the level has to
+  // be rebuilt instead.  It also cancels any shape being drawn, whose
+  // nodes the restore would otherwise remove from under it.
+  LuaCallbacks* callbacks = GameManager::sharedManager()->GetLuaCallbacks();
+  if (!callbacks->Has(LUA_CALLBACK_RESTART_LEVEL) ||
+      !callbacks->Push(LUA_CALLBACK_PREPARE_RESTART_LEVEL) ||
+      callbacks->Call(0) != 1)
+    return false;
+
+  if (stroke_builder_)
+    stroke_builder_->Cancel();
+  // The preview was started from the state being thrown away.
+  CancelPreview();
+  snapshot_.Restore(box2d_world_, this);
+
+  // Restoring the bodies ends all of their contacts.  The lua state is
+  // reset too, so drop the resulting events rather than reporting them.
+  contact_events_.clear();
+  contact_counts_.Clear();
+  impact_events_.clear();
+  impact_indices_.Clear();
+  trigger_overlaps_.clear();
+  physics_accumulator_ = 0;
+
+  callbacks->Push(LUA_CALLBACK_RESTART_LEVEL);
+  return callbacks->Call(0) == 1;
+}
+
+LevelLayer::LevelLayer()
+    : box2d_world_(NULL),
+      world_pool_(NULL),
+      static_body_(NULL),
+      physics_timestep_(1.0f / DEFAULT_PHYSICS_RATE),
+      max_physics_steps_(DEFAULT_MAX_PHYSICS_STEPS),
+      physics_accumulator_(0),
+      velocity_iterations_(DEFAULT_VELOCITY_ITERATIONS),
+      position_iterations_(DEFAULT_POSITION_ITERATIONS),
+      native_step_(true),
+      physics_paused_(false),
+      continuous_physics_(true),
+      step_time_ms_(0),
+      steps_run_(0),
+      quality_changed_(false),
+      physics_thread_(NULL),
+      physics_task_(NULL),
+      physics_pending_(false),
+      pending_velocity_iterations_(0),
+      pending_position_iterations_(0),
+      step_in_flight_(false),
+      post_step_handler_(0),
+      preview_(NULL),
+      preview_handler_(0),
+      stroke_builder_(NULL),
+      triggers_(TRIGGER_CELL_SIZE),
+      global_impact_threshold_(0),
+      impact_threshold_count_(0),
+      global_contact_interest_(CONTACT_INTEREST_BEGAN | CONTACT_INTEREST_ENDED),
+      debug_enabled_(false),
+      level_complete_(false) {
+  contact_events_.reserve(CONTACT_EVENT_RESERVE);
 }
 
 LevelLayer::~LevelLayer() {
-  delete box2d_world_;
+  SetPostStepHandler(0);
+  // Stops the thread once any running step has completed.
+  delete physics_thread_;
+  delete physics_task_;
+  CancelPreview();
+  delete preview_;
+  delete stroke_builder_;
+  // Returns the world, emptied, to the pool for the next level.
+  if (world_pool_)
+    world_pool_->Release(box2d_world_);
 #ifdef COCOS2D_DEBUG
 #ifndef WIN32
   delete box2d_debug_draw_;
@@ -88,9 +420,15 @@ bool LevelLayer::LoadLua(int level_number) {
   lua_stack_ = engine->getLuaStack();
   assert(lua_stack_);
 
+  LuaCallbacks* callbacks = GameManager::sharedManager()->GetLuaCallbacks();
+  if (!callbacks->Push(LUA_CALLBACK_LOAD_LEVEL)) {
+    assert(false && "LoadLevel not defined");
+    return false;
+  }
+
   lua_stack_->pushCCObject(this, "LevelLayer");
   lua_stack_->pushInt(level_number);
-  int rtn = lua_stack_->executeFunctionByName("LoadLevel", 2);
+  int rtn = callbacks->Call(2);
   if (rtn == -1) {
     assert(false && "level loading failed");
     return false;
@@ -100,10 +438,10 @@ bool LevelLayer::LoadLua(int level_number) {
 }
 
 bool LevelLayer::InitPhysics() {
-  b2Vec2 gravity(0.0f, -9.8f);
-  box2d_world_ = new b2World(gravity);
-  box2d_world_->SetAllowSleeping(true);
-  box2d_world_->SetContinuousPhysics(true);
+  // Reusing a world keeps its allocator pages from the previous level.
+  world_pool_ = GameManager::sharedManager()->GetWorldPool();
+  box2d_world_ = world_pool_->Acquire();
+  box2d_world_->SetContinuousPhysics(continuous_physics_);
   box2d_world_->SetContactListener(this);
 
 #ifdef COCOS2D_DEBUG
@@ -123,6 +461,565 @@ bool LevelLayer::InitPhysics() {
   return true;
 }
 
+int LevelLayer::TagForFixture(b2Fixture* fixture) {
+  int tag = (intptr_t)fixture->GetUserData();
+  if (tag)
+    return tag;
+  return (intptr_t)fixture->GetBody()->GetUserData();
+}
+
+b2Body* LevelLayer::GetStaticBody() {
+  if (!static_body_) {
+    b2BodyDef body_def;
+    static_body_ = box2d_world_->CreateBody(&body_def);
+  }
+  return static_body_;
+}
+
+void LevelLayer::SetFixtureTag(b2Fixture* fixture, int tag) {
+  fixture->SetUserData((void*)(intptr_t)tag);
+}
+
+int LevelLayer::AddStaticEdges(int edges) {
+  lua_State* state = lua_stack_->getLuaState();
+  int num_edges = lua_objlen(state, edges) / 5;
+  std::vector<StaticEdge> edge_list(num_edges);
+  for (int i = 0; i < num_edges; i++) {
+    StaticEdge& edge = edge_list[i];
+    edge.start.Set(GetArrayNumber(state, edges, i * 5 + 1),
+                   GetArrayNumber(state, edges, i * 5 + 2));
+    edge.finish.Set(GetArrayNumber(state, edges, i * 5 + 3),
+                    GetArrayNumber(state, edges, i * 5 + 4));
+    edge.tag = (int)GetArrayNumber(state, edges, i * 5 + 5);
+  }
+
+  b2Body* body = GetStaticBody();
+  int fixture_count = 0;
+  std::vector<b2Vec2> chain;
+  std::vector<bool> used(num_edges, false);
+  for (int i = 0; i < num_edges; i++) {
+    if (used[i])
+      continue;
+    bool loop = BuildChain(edge_list, i, &used, &chain);
+
+    b2Fixture* fixture;
+    if (chain.size() == 2) {
+      b2EdgeShape shape;
+      shape.Set(chain[0], chain[1]);
+      fixture = body->CreateFixture(&shape, 0);
+    } else {
+      b2ChainShape shape;
+      if (loop)
+        shape.CreateLoop(&chain[0], chain.size());
+      else
+        shape.CreateChain(&chain[0], chain.size());
+      fixture = body->CreateFixture(&shape, 0);
+    }
+    SetFixtureTag(fixture, edge_list[i].tag);
+    fixture_count++;
+  }
+
+  CCLog("merged %d static edges into %d fixtures", num_edges, fixture_count);
+  return fixture_count;
+}
+
+void LevelLayer::ApplyPhysicsSettings(int settings) {
+  lua_State* state = lua_stack_->getLuaState();
+  // The world settings must not change under a running threaded step.
+  WaitForPhysics();
+
+  b2Vec2 gravity = box2d_world_->GetGravity();
+  lua_getfield(state, settings, "gravity");
+  if (lua_istable(state, -1)) {
+    int gravity_table = lua_gettop(state);
+    gravity.Set(GetArrayNumber(state, gravity_table, 1),
+                GetArrayNumber(state, gravity_table, 2));
+  }
+  lua_pop(state, 1);
+  box2d_world_->SetGravity(gravity);
+
+  box2d_world_->SetAllowSleeping(GetFieldBool(
+      state, settings, "allow_sleeping", box2d_world_->GetAllowSleeping()));
+  box2d_world_->SetWarmStarting(GetFieldBool(
+      state, settings, "warm_starting", box2d_world_->GetWarmStarting()));
+  box2d_world_->SetSubStepping(GetFieldBool(
+      state, settings, "sub_stepping", box2d_world_->GetSubStepping()));
+  continuous_physics_ = GetFieldBool(state, settings, "continuous",
+                                     continuous_physics_);
+
+  SetPhysicsRate(
+      GetFieldNumber(state, settings, "rate", 1.0f / physics_timestep_),
+      (int)GetFieldNumber(state, settings, "max_steps", max_physics_steps_));
+  SetPhysicsIterations(
+      (int)GetFieldNumber(state, settings, "velocity_iterations",
+                          velocity_iterations_),
+      (int)GetFieldNumber(state, settings, "position_iterations",
+                          position_iterations_));
+  SetNativeStep(GetFieldBool(state, settings, "native_step", native_step_));
+  // Also applies continuous_physics_ to the world.
+  SetPhysicsBudget(GetFieldNumber(state, settings, "step_budget",
+                                  governor_.GetBudget()));
+  SetThreadedPhysics(GetFieldBool(state, settings, "threaded",
+                                  physics_thread_ != NULL));
+
+  CCLog("physics: gravity %.2f,%.2f rate %.0fHz iterations %d/%d ccd %d",
+        gravity.x, gravity.y, 1.0f / physics_timestep_, velocity_iterations_,
+        position_iterations_, continuous_physics_);
+}
+
+int LevelLayer::AddStaticBoxes(int boxes) {
+  lua_State* state = lua_stack_->getLuaState();
+  int num_boxes = lua_objlen(state, boxes) / 6;
+  b2Body* body = GetStaticBody();
+  const b2Vec2& origin = body->GetPosition();
+
+  // Matches the fixtures that drawing.lua creates for lines.
+  b2PolygonShape shape;
+  b2FixtureDef fixture_def;
+  fixture_def.shape = &shape;
+  fixture_def.density = 1.0f;
+  fixture_def.friction = 0.5f;
+  fixture_def.restitution = 0.3f;
+  for (int i = 0; i < num_boxes; i++) {
+    b2Vec2 start(GetArrayNumber(state, boxes, i * 6 + 1),
+                 GetArrayNumber(state, boxes, i * 6 + 2));
+    b2Vec2 finish(GetArrayNumber(state, boxes, i * 6 + 3),
+                  GetArrayNumber(state, boxes, i * 6 + 4));
+    float half_thickness = GetArrayNumber(state, boxes, i * 6 + 5);
+    int tag = (int)GetArrayNumber(state, boxes, i * 6 + 6);
+
+    b2Vec2 direction = finish - start;
+    b2Vec2 center = 0.5f * (start + finish) - origin;
+    shape.SetAsBox(0.5f * direction.Length(), half_thickness, center,
+                   atan2f(direction.y, direction.x));
+    SetFixtureTag(body->CreateFixture(&fixture_def), tag);
+  }
+
+  CCLog("added %d static boxes", num_boxes);
+  return num_boxes;
+}
+
+void LevelLayer::SetPhysicsRate(float hz, int max_steps) {
+  assert(hz > 0);
+  assert(max_steps > 0);
+  physics_timestep_ = 1.0f / hz;
+  max_physics_steps_ = max_steps;
+}
+
+void LevelLayer::SetPhysicsIterations(int velocity_iterations,
+                                      int position_iterations) {
+  velocity_iterations_ = velocity_iterations;
+  position_iterations_ = position_iterations;
+}
+
+void LevelLayer::SetNativeStep(bool enabled) {
+  native_step_ = enabled;
+}
+
+void LevelLayer::SetPhysicsPaused(bool paused) {
+  physics_paused_ = paused;
+}
+
+void LevelLayer::SetThreadedPhysics(bool enabled) {
+  if (!enabled) {
+    delete physics_thread_;
+    physics_thread_ = NULL;
+    if (physics_pending_) {
+      physics_pending_ = false;
+      RunPhysicsSteps(pending_velocity_iterations_,
+                      pending_position_iterations_);
+      FinishPhysicsSteps();
+    }
+    return;
+  }
+
+  if (physics_thread_)
+    return;
+  physics_thread_ = new WorkerThread();
+  if (!physics_thread_->Start()) {
+    CCLog("failed to start physics thread");
+    delete physics_thread_;
+    physics_thread_ = NULL;
+    return;
+  }
+  if (!physics_task_)
+    physics_task_ = new PhysicsStepTask(this);
+}
+
+void LevelLayer::SetPostStepHandler(int lua_handler) {
+  if (post_step_handler_) {
+    CCScriptEngineManager* manager = CCScriptEngineManager::sharedManager();
+    manager->getScriptEngine()->removeScriptHandler(post_step_handler_);
+  }
+  post_step_handler_ = lua_handler;
+}
+
+static uint8_t ContactInterestMask(bool began, bool ended) {
+  uint8_t mask = 0;
+  if (began)
+    mask |= CONTACT_INTEREST_BEGAN;
+  if (ended)
+    mask |= CONTACT_INTEREST_ENDED;
+  return mask;
+}
+
+void LevelLayer::SetContactInterest(int tag, bool began, bool ended) {
+  assert(tag > 0);
+  if (tag >= (int)contact_interest_.size())
+    contact_interest_.resize(tag + 1, 0);
+  contact_interest_[tag] = ContactInterestMask(began, ended);
+}
+
+void LevelLayer::SetGlobalContactInterest(bool began, bool ended) {
+  global_contact_interest_ = ContactInterestMask(began, ended);
+}
+
+void LevelLayer::update(float delta) {
+  if (native_step_)
+    StepPhysics(delta, velocity_iterations_, position_iterations_);
+
+  DeliverPreview();
+
+  if (quality_changed_)
+    ReportPhysicsQuality();
+
+  // Lets CCNode run any handler set with scheduleUpdateWithPriorityLua.
+  CCLayerColor::update(delta);
+
+  if (post_step_handler_) {
+    lua_stack_->pushFloat(delta);
+    lua_stack_->executeFunctionByHandler(post_step_handler_, 1);
+  }
+}
+
+void LevelLayer::StepPhysics(float delta, int velocity_iterations,
+                             int position_iterations) {
+  if (physics_paused_)
+    return;
+
+  physics_accumulator_ += delta;
+
+  if (governor_.IsEnabled()) {
+    governor_.SetIterations(velocity_iterations, position_iterations);
+    velocity_iterations = governor_.GetVelocityIterations();
+    position_iterations = governor_.GetPositionIterations();
+  }
+
+  if (physics_thread_) {
+    // The steps are run by visit() while the layer is drawn.  Contacts
+    // from the previous step are delivered now that it has completed.
+    physics_pending_ = true;
+    pending_velocity_iterations_ = velocity_iterations;
+    pending_position_iterations_ = position_iterations;
+    DispatchContactEvents();
+    DispatchImpactEvents();
+    return;
+  }
+
+  RunPhysicsSteps(velocity_iterations, position_iterations);
+  FinishPhysicsSteps();
+
+  // Contacts are only passed to lua once the world is no longer locked
+  // so that the handlers are free to create and destroy bodies.
+  DispatchContactEvents();
+  DispatchImpactEvents();
+}
+
+void LevelLayer::RunPhysicsSteps(int velocity_iterations,
+                                 int position_iterations) {
+  // Box2D's global state is not thread safe, so the preview world is
+  // held between its steps while the level's world is stepped.
+  if (preview_)
+    preview_->Pause();
+  int steps = 0;
+  while (physics_accumulator_ >= physics_timestep_) {
+    if (steps == max_physics_steps_) {
+      // Drop any time we could not catch up on rather than letting it
+      // build up, so that a single slow frame can't trigger an ever
+      // increasing number of steps.
+      physics_accumulator_ = fmodf(physics_accumulator_, physics_timestep_);
+      break;
+    }
+    SavePhysicsState();
+    box2d_world_->Step(physics_timestep_, velocity_iterations,
+                       position_iterations);
+    step_time_ms_ += box2d_world_->GetProfile().step;
+    CheckTriggers();
+    steps_run_++;
+    physics_accumulator_ -= physics_timestep_;
+    steps++;
+  }
+  if (preview_)
+    preview_->Resume();
+}
+
+void LevelLayer::SetPhysicsBudget(float budget_ms) {
+  governor_.SetBudget(budget_ms);
+  box2d_world_->SetContinuousPhysics(continuous_physics_);
+}
+
+bool LevelLayer::HasBulletBodies() {
+  for (b2Body* body = box2d_world_->GetBodyList(); body;
+       body = body->GetNext()) {
+    if (body->IsBullet())
+      return true;
+  }
+  return false;
+}
+
+void LevelLayer::UpdateGovernor() {
+  if (!steps_run_)
+    return;
+  float step_time_ms = step_time_ms_;
+  step_time_ms_ = 0;
+  steps_run_ = 0;
+
+  // Turning off CCD would let bullets tunnel, so it is only allowed
+  // while there are none.  Only look for them once the governor has
+  // run out of iterations to cut.
+  bool allow_no_ccd = governor_.AtLowestIterations() && !HasBulletBodies();
+  if (!governor_.AddSample(step_time_ms, allow_no_ccd))
+    return;
+
+  box2d_world_->SetContinuousPhysics(continuous_physics_ &&
+                                     governor_.GetContinuousPhysics());
+  CCLog("physics quality %d (%.2fms per frame): iterations %d/%d ccd %d",
+        governor_.GetLevel(), governor_.GetAverage(),
+        governor_.GetVelocityIterations(), governor_.GetPositionIterations(),
+        governor_.GetContinuousPhysics());
+  quality_changed_ = true;
+}
+
+void LevelLayer::ReportPhysicsQuality() {
+  quality_changed_ = false;
+  LuaCallbacks* callbacks = GameManager::sharedManager()->GetLuaCallbacks();
+  if (!callbacks->Push(LUA_CALLBACK_PHYSICS_QUALITY))
+    return;
+  lua_stack_->pushInt(governor_.GetLevel());
+  lua_stack_->pushInt(governor_.GetVelocityIterations());
+  lua_stack_->pushInt(governor_.GetPositionIterations());
+  lua_stack_->pushBoolean(governor_.GetContinuousPhysics());
+  lua_stack_->pushFloat(governor_.GetAverage());
+  callbacks->Call(5);
+}
+
+void LevelLayer::WaitForPhysics() {
+  if (physics_thread_)
+    physics_thread_->Wait();
+  step_in_flight_ = false;
+}
+
+void LevelLayer::visit() {
+  if (!physics_pending_) {
+    CCLayerColor::visit();
+    return;
+  }
+
+  // The nodes are drawn at their current render transforms, which the
+  // physics steps don't touch, so the two can safely overlap.  Physics
+  // nodes assert that nothing on the draw path reads their bodies in
+  // the meantime.  No lua code runs during visit().
+  physics_pending_ = false;
+  step_in_flight_ = true;
+  physics_thread_->Post(physics_task_);
+  CCLayerColor::visit();
+  WaitForPhysics();
+  FinishPhysicsSteps();
+}
+
+void LevelLayer::FinishPhysicsSteps() {
+  InterpolatePhysicsState(physics_accumulator_ / physics_timestep_);
+  UpdateGovernor();
+  world_pool_->RecordUsage(box2d_world_);
+}
+
+// Returns true if the body can have moved during the last step.
+// Static bodies only move when their node is moved, which resets the
+// node's physics state directly.
+static bool IsMoving(b2Body* body) {
+  return body && body->IsAwake() && body->GetType() != b2_staticBody;
+}
+
+void LevelLayer::SavePhysicsState() {
+  for (size_t i = 0; i < physics_nodes_.size(); i++) {
+    b2Body* body = physics_nodes_[i]->getB2Body();
+    if (!IsMoving(body))
+      continue;
+    const b2Vec2& position = body->GetPosition();
+    previous_x_[i] = position.x;
+    previous_y_[i] = position.y;
+    previous_angle_[i] = body->GetAngle();
+  }
+}
+
+void LevelLayer::InterpolatePhysicsState(float alpha) {
+  // Gather the moving bodies into the sync arrays.  A body that has
+  // just fallen asleep is synced one last time, with the previous state
+  // snapped to its final transform.
+  sync_slots_.clear();
+  sync_x_.clear();
+  sync_y_.clear();
+  sync_angle_.clear();
+  for (size_t i = 0; i < physics_nodes_.size(); i++) {
+    b2Body* body = physics_nodes_[i]->getB2Body();
+    bool moving = IsMoving(body);
+    if (!moving && (!slot_moving_[i] || !body)) {
+      slot_moving_[i] = false;
+      continue;
+    }
+    slot_moving_[i] = moving;
+
+    const b2Vec2& position = body->GetPosition();
+    if (!moving) {
+      previous_x_[i] = position.x;
+      previous_y_[i] = position.y;
+      previous_angle_[i] = body->GetAngle();
+    }
+    sync_slots_.push_back(i);
+    sync_x_.push_back(position.x);
+    sync_y_.push_back(position.y);
+    sync_angle_.push_back(body->GetAngle());
+  }
+
+  size_t count = sync_slots_.size();
+  if (!count)
+    return;
+
+  // Interpolate in place between the previous and current transforms.
+  float32* x = &sync_x_[0];
+  float32* y = &sync_y_[0];
+  float32* angle = &sync_angle_[0];
+  for (size_t i = 0; i < count; i++) {
+    int slot = sync_slots_[i];
+    x[i] = previous_x_[slot] + alpha * (x[i] - previous_x_[slot]);
+    y[i] = previous_y_[slot] + alpha * (y[i] - previous_y_[slot]);
+    angle[i] = previous_angle_[slot] +
+               alpha * (angle[i] - previous_angle_[slot]);
+  }
+
+  for (size_t i = 0; i < count; i++)
+    physics_nodes_[sync_slots_[i]]->SetRenderState(x[i], y[i], angle[i]);
+}
+
+void LevelLayer::RegisterPhysicsNode(PhysicsBodyNode* node) {
+  assert(node->GetPhysicsSlot() == -1);
+  node->SetPhysicsSlot(physics_nodes_.size());
+  physics_nodes_.push_back(node);
+  previous_x_.push_back(0);
+  previous_y_.push_back(0);
+  previous_angle_.push_back(0);
+  slot_moving_.push_back(false);
+  ResetPhysicsNode(node);
+  if (!trigger_activator_tags_.empty())
+    UpdateTriggerActivators();
+}
+
+void LevelLayer::UnregisterPhysicsNode(PhysicsBodyNode* node) {
+  int slot = node->GetPhysicsSlot();
+  if (slot < 0)
+    return;
+  assert(physics_nodes_[slot] == node);
+
+  // Move the last node into the removed node's slot.
+  int last = physics_nodes_.size() - 1;
+  if (slot != last) {
+    physics_nodes_[slot] = physics_nodes_[last];
+    previous_x_[slot] = previous_x_[last];
+    previous_y_[slot] = previous_y_[last];
+    previous_angle_[slot] = previous_angle_[last];
+    slot_moving_[slot] = slot_moving_[last];
+    physics_nodes_[slot]->SetPhysicsSlot(slot);
+  }
+  physics_nodes_.pop_back();
+  previous_x_.pop_back();
+  previous_y_.pop_back();
+  previous_angle_.pop_back();
+  slot_moving_.pop_back();
+  node->SetPhysicsSlot(-1);
+
+  std::vector<PhysicsBodyNode*>::iterator activator =
+      std::find(trigger_activators_.begin(), trigger_activators_.end(), node);
+  if (activator != trigger_activators_.end())
+    trigger_activators_.erase(activator);
+}
+
+void LevelLayer::ResetPhysicsNode(PhysicsBodyNode* node) {
+  int slot = node->GetPhysicsSlot();
+  b2Body* body = node->getB2Body();
+  if (slot < 0 || !body)
+    return;
+  const b2Vec2& position = body->GetPosition();
+  previous_x_[slot] = position.x;
+  previous_y_[slot] = position.y;
+  previous_angle_[slot] = body->GetAngle();
+  // Sync the node at least once so that its render state is current.
+  slot_moving_[slot] = true;
+}
+
+bool LevelLayer::StartPreview(int tags, int steps, int sample_interval,
+                              int lua_handler) {
+  lua_State* state = lua_stack_->getLuaState();
+  std::vector<int> tag_list;
+  int num_tags = lua_objlen(state, tags);
+  for (int i = 1; i <= num_tags; i++)
+    tag_list.push_back((int)GetArrayNumber(state, tags, i));
+
+  // The world must not be copied while a threaded step is running, and
+  // that step reads preview_.
+  WaitForPhysics();
+  CancelPreview();
+  if (!preview_)
+    preview_ = new WorldPreview();
+
+  if (!preview_->Start(box2d_world_, tag_list, steps, sample_interval,
+                       physics_timestep_, velocity_iterations_,
+                       position_iterations_)) {
+    CCScriptEngineManager* manager = CCScriptEngineManager::sharedManager();
+    manager->getScriptEngine()->removeScriptHandler(lua_handler);
+    return false;
+  }
+  preview_handler_ = lua_handler;
+  return true;
+}
+
+void LevelLayer::CancelPreview() {
+  if (preview_)
+    preview_->Cancel();
+  if (preview_handler_) {
+    CCScriptEngineManager* manager = CCScriptEngineManager::sharedManager();
+    manager->getScriptEngine()->removeScriptHandler(preview_handler_);
+    preview_handler_ = 0;
+  }
+}
+
+StrokeBuilder* LevelLayer::GetStrokeBuilder() {
+  if (!stroke_builder_)
+    stroke_builder_ = new StrokeBuilder(this);
+  return stroke_builder_;
+}
+
+void LevelLayer::DeliverPreview() {
+  if (!preview_ || !preview_->PollFinished() || !preview_handler_)
+    return;
+
+  // The handler is released before it is called so that it is free to
+  // start another preview.
+  int handler = preview_handler_;
+  preview_handler_ = 0;
+
+  lua_State* state = lua_stack_->getLuaState();
+  const std::vector<float>& samples = preview_->GetSamples();
+  lua_createtable(state, samples.size(), 0);
+  int table = lua_gettop(state);
+  for (size_t i = 0; i < samples.size(); i++)
+    SetArrayNumber(state, table, i + 1, samples[i]);
+  lua_stack_->pushInt(preview_->GetSampleCount());
+  lua_stack_->executeFunctionByHandler(handler, 2);
+
+  CCScriptEngineManager* manager = CCScriptEngineManager::sharedManager();
+  manager->getScriptEngine()->removeScriptHandler(handler);
+}
+
 void LevelLayer::ToggleDebug() {
   debug_enabled_ = !debug_enabled_;
 
@@ -144,42 +1041,253 @@ CCRect CalcBoundingBox(CCSprite* sprite) {
                     size.width, size.height/2);
 }
 
-void LevelLayer::LuaNotifyContact(b2Contact* contact,
-                                    const char* function_name) {
-  // Return early if lua didn't define the function_name
+void LevelLayer::QueueContactEvent(b2Contact* contact, bool began) {
+  // Only send to lua collitions between body's that
+  // have been tagged.
+  int tag1 = TagForFixture(contact->GetFixtureA());
+  int tag2 = TagForFixture(contact->GetFixtureB());
+  if (!tag1 || !tag2)
+    return;
+
+  if (began) {
+    if (contact_counts_(tag1, tag2)++ > 0)
+      return;
+  } else {
+    int* count = contact_counts_.Find(tag1, tag2);
+    if (!count)
+      return;
+    if (--(*count) > 0)
+      return;
+    contact_counts_.Remove(tag1, tag2);
+  }
+
+  QueueTagEvent(tag1, tag2, began);
+}
+
+void LevelLayer::QueueTagEvent(int tag1, int tag2, bool began) {
+  // Drop the event if nobody is interested in it.
+  uint8_t interest = global_contact_interest_;
+  if (tag1 < (int)contact_interest_.size())
+    interest |= contact_interest_[tag1];
+  if (tag2 < (int)contact_interest_.size())
+    interest |= contact_interest_[tag2];
+  if (!(interest & (began ? CONTACT_INTEREST_BEGAN : CONTACT_INTEREST_ENDED)))
+    return;
+
+  ContactEvent event = { tag1, tag2, began };
+  contact_events_.push_back(event);
+}
+
+void LevelLayer::AddTrigger(int tag, b2Vec2* center, float radius) {
+  assert(tag);
+  triggers_.Add(tag, *center, radius);
+}
+
+void LevelLayer::RemoveTrigger(int tag) {
+  triggers_.Remove(tag);
+}
+
+void LevelLayer::SetTriggerActivator(int tag, bool enabled) {
+  if (tag >= (int)trigger_activator_tags_.size())
+    trigger_activator_tags_.resize(tag + 1);
+  trigger_activator_tags_[tag] = enabled;
+  UpdateTriggerActivators();
+}
+
+void LevelLayer::UpdateTriggerActivators() {
+  trigger_activators_.clear();
+  for (size_t i = 0; i < physics_nodes_.size(); i++) {
+    b2Body* body = physics_nodes_[i]->getB2Body();
+    if (!body)
+      continue;
+    int tag = (intptr_t)body->GetUserData();
+    if (tag < (int)trigger_activator_tags_.size() &&
+        trigger_activator_tags_[tag])
+      trigger_activators_.push_back(physics_nodes_[i]);
+  }
+}
+
+void LevelLayer::CheckTriggers() {
+  if (triggers_.IsEmpty() && trigger_overlaps_.empty())
+    return;
+
+  new_trigger_overlaps_.clear();
+  for (size_t i = 0; i < trigger_activators_.size(); i++) {
+    b2Body* body = trigger_activators_[i]->getB2Body();
+    b2Fixture* fixture = body->GetFixtureList();
+    if (!fixture)
+      continue;
+
+    // The fixture bounds kept by the broad-phase cover the movement of
+    // the body during the last step, so fast activators can't skip
+    // over a trigger.
+    b2AABB aabb = fixture->GetAABB(0);
+    for (; fixture; fixture = fixture->GetNext()) {
+      int child_count = fixture->GetShape()->GetChildCount();
+      for (int child = 0; child < child_count; child++)
+        aabb.Combine(fixture->GetAABB(child));
+    }
+
+    trigger_query_.clear();
+    triggers_.Query(aabb, &trigger_query_);
+    int tag = (intptr_t)body->GetUserData();
+    for (size_t j = 0; j < trigger_query_.size(); j++)
+      new_trigger_overlaps_.push_back(std::make_pair(tag, trigger_query_[j]));
+  }
+  std::sort(new_trigger_overlaps_.begin(), new_trigger_overlaps_.end());
+
+  // Both lists are sorted, so walk them together to find the overlaps
+  // that were added or removed.
+  size_t old_index = 0;
+  size_t new_index = 0;
+  while (old_index < trigger_overlaps_.size() ||
+         new_index < new_trigger_overlaps_.size()) {
+    if (new_index == new_trigger_overlaps_.size() ||
+        (old_index < trigger_overlaps_.size() &&
+         trigger_overlaps_[old_index] < new_trigger_overlaps_[new_index])) {
+      const std::pair<int, int>& ended = trigger_overlaps_[old_index++];
+      QueueTagEvent(ended.first, ended.second, false);
+    } else if (old_index == trigger_overlaps_.size() ||
+               new_trigger_overlaps_[new_index] < trigger_overlaps_[old_index]) {
+      const std::pair<int, int>& began = new_trigger_overlaps_[new_index++];
+      QueueTagEvent(began.first, began.second, true);
+    } else {
+      old_index++;
+      new_index++;
+    }
+  }
+  trigger_overlaps_.swap(new_trigger_overlaps_);
+}
+
+void LevelLayer::DispatchContactEvents() {
+  if (contact_events_.empty())
+    return;
+
+  // Drop the events if lua didn't define a handler for them.
+  LuaCallbacks* callbacks = GameManager::sharedManager()->GetLuaCallbacks();
+  if (!callbacks->Push(LUA_CALLBACK_CONTACT_EVENTS)) {
+    contact_events_.clear();
+    return;
+  }
+
+  // Pass the events to lua as a flat array of
+  // { tag1, tag2, began, tag1, tag2, began, ... }
   lua_State* state = lua_stack_->getLuaState();
-  lua_getglobal(state, function_name);
-  bool is_func = lua_isfunction(state, -1);
-  lua_pop(state, 1);
+  int count = contact_events_.size();
+  lua_createtable(state, count * 3, 0);
+  for (int i = 0; i < count; i++) {
+    const ContactEvent& event = contact_events_[i];
+    lua_pushinteger(state, event.tag1);
+    lua_rawseti(state, -2, i * 3 + 1);
+    lua_pushinteger(state, event.tag2);
+    lua_rawseti(state, -2, i * 3 + 2);
+    lua_pushboolean(state, event.began);
+    lua_rawseti(state, -2, i * 3 + 3);
+  }
+
+  // Clear the queue before calling into lua since the handlers can
+  // destroy bodies, which in turn generates new EndContact events.
+  contact_events_.clear();
+  callbacks->Call(1);
+}
+
+void LevelLayer::SetImpactThreshold(int tag, float threshold) {
+  if (tag >= (int)impact_thresholds_.size())
+    impact_thresholds_.resize(tag + 1);
+  if (impact_thresholds_[tag] > 0)
+    impact_threshold_count_--;
+  impact_thresholds_[tag] = std::max(threshold, 0.0f);
+  if (impact_thresholds_[tag] > 0)
+    impact_threshold_count_++;
+}
+
+void LevelLayer::SetGlobalImpactThreshold(float threshold) {
+  global_impact_threshold_ = std::max(threshold, 0.0f);
+}
 
-  if (!is_func)
+float LevelLayer::ImpactThreshold(int tag1, int tag2) {
+  float threshold = global_impact_threshold_;
+  int tags[2] = { tag1, tag2 };
+  for (int i = 0; i < 2; i++) {
+    if (tags[i] >= (int)impact_thresholds_.size())
+      continue;
+    float tag_threshold = impact_thresholds_[tags[i]];
+    if (tag_threshold > 0 && (threshold == 0 || tag_threshold < threshold))
+      threshold = tag_threshold;
+  }
+  return threshold;
+}
+
+void LevelLayer::PostSolve(b2Contact* contact,
+                           const b2ContactImpulse* impulse) {
+  // This is called for every touching contact on every step, so bail
+  // out early unless lua wants impacts.
+  if (!impact_threshold_count_ && global_impact_threshold_ == 0)
     return;
 
-  // Only send to lua collitions between body's that
-  // have been tagged.
-  b2Body* body1 = contact->GetFixtureA()->GetBody();
-  b2Body* body2 = contact->GetFixtureB()->GetBody();
-  int tag1 = (intptr_t)body1->GetUserData();
-  int tag2 = (intptr_t)body2->GetUserData();
+  int tag1 = TagForFixture(contact->GetFixtureA());
+  int tag2 = TagForFixture(contact->GetFixtureB());
   if (!tag1 || !tag2)
     return;
 
-  // Call the lua function callback passing in tags of the two bodies that
-  // collided
-  lua_stack_->pushInt(tag1);
-  lua_stack_->pushInt(tag2);
-  lua_stack_->executeFunctionByName(function_name, 2);
+  float max_impulse = 0;
+  for (int i = 0; i < impulse->count; i++)
+    max_impulse = std::max(max_impulse, impulse->normalImpulses[i]);
+  float threshold = ImpactThreshold(tag1, tag2);
+  if (threshold == 0 || max_impulse < threshold)
+    return;
+
+  // Keep only the hardest impact of each pair.
+  int& index = impact_indices_(tag1, tag2);
+  if (!index) {
+    ImpactEvent event = { tag1, tag2, max_impulse };
+    impact_events_.push_back(event);
+    index = impact_events_.size();
+  } else if (max_impulse > impact_events_[index - 1].impulse) {
+    impact_events_[index - 1].impulse = max_impulse;
+  }
+}
+
+void LevelLayer::DispatchImpactEvents() {
+  if (impact_events_.empty())
+    return;
+  impact_indices_.Clear();
+
+  LuaCallbacks* callbacks = GameManager::sharedManager()->GetLuaCallbacks();
+  if (!callbacks->Push(LUA_CALLBACK_CONTACT_IMPULSES)) {
+    impact_events_.clear();
+    return;
+  }
+
+  // Pass the impacts to lua as a flat array of
+  // { tag1, tag2, impulse, tag1, tag2, impulse, ... }
+  lua_State* state = lua_stack_->getLuaState();
+  int count = impact_events_.size();
+  lua_createtable(state, count * 3, 0);
+  for (int i = 0; i < count; i++) {
+    const ImpactEvent& event = impact_events_[i];
+    lua_pushinteger(state, event.tag1);
+    lua_rawseti(state, -2, i * 3 + 1);
+    lua_pushinteger(state, event.tag2);
+    lua_rawseti(state, -2, i * 3 + 2);
+    lua_pushnumber(state, event.impulse);
+    lua_rawseti(state, -2, i * 3 + 3);
+  }
+
+  impact_events_.clear();
+  callbacks->Call(1);
 }
 
 void LevelLayer::BeginContact(b2Contact* contact) {
-  LuaNotifyContact(contact, "OnContactBegan");
+  QueueContactEvent(contact, true);
 }
 
 void LevelLayer::EndContact(b2Contact* contact) {
-  LuaNotifyContact(contact, "OnContactEnded");
+  QueueContactEvent(contact, false);
 }
 
 void LevelLayer::LevelComplete() {
+  level_complete_ = true;
   setTouchEnabled(false);
   GameManager::sharedManager()->GameOver(true);
 }
@@ -189,6 +1297,8 @@ void LevelLayer::draw() {
 
 #ifdef COCOS2D_DEBUG
   if (debug_enabled_) {
+    // The debug data is read straight from the world.
+    WaitForPhysics();
     ccGLEnableVertexAttribs(kCCVertexAttribFlag_Position);
     kmGLPushMatrix();
     box2d_world_->DrawDebugData();
@@ -197,7 +1307,8 @@ void LevelLayer::draw() {
 #endif
 }
 
-void LevelLayer::FindBodiesAt(b2Vec2* pos, int lua_handler) {
+int LevelLayer::FindBodiesAt(b2Vec2* pos, int lua_table,
+                             bool sort_by_draw_order) {
   b2AABB aabb;
   b2Vec2 d;
   d.Set(0.001f, 0.001f);
@@ -205,6 +1316,101 @@ void LevelLayer::FindBodiesAt(b2Vec2* pos, int lua_handler) {
   aabb.upperBound = *pos + d;
 
   // Query the world for overlapping shapes.
-  Box2DCallbackHandler handler(pos, lua_stack_, lua_handler);
-  box2d_world_->QueryAABB(&handler, aabb);
+  std::vector<int> tags;
+  PointQueryCallback callback(*pos, &tags);
+  box2d_world_->QueryAABB(&callback, aabb);
+
+  if (sort_by_draw_order)
+    std::stable_sort(tags.begin(), tags.end(), DrawOrderCompare(this));
+
+  lua_State* state = lua_stack_->getLuaState();
+  for (size_t i = 0; i < tags.size(); i++) {
+    lua_pushinteger(state, tags[i]);
+    lua_rawseti(state, lua_table, i + 1);
+  }
+  return tags.size();
+}
+
+int LevelLayer::QueryRegion(int regions, int results) {
+  lua_State* state = lua_stack_->getLuaState();
+  int num_regions = lua_objlen(state, regions) / 4;
+  int count = 0;
+  std::vector<int> tags;
+  for (int i = 0; i < num_regions; i++) {
+    b2AABB aabb;
+    float x1 = GetArrayNumber(state, regions, i * 4 + 1);
+    float y1 = GetArrayNumber(state, regions, i * 4 + 2);
+    float x2 = GetArrayNumber(state, regions, i * 4 + 3);
+    float y2 = GetArrayNumber(state, regions, i * 4 + 4);
+    aabb.lowerBound.Set(b2Min(x1, x2), b2Min(y1, y2));
+    aabb.upperBound.Set(b2Max(x1, x2), b2Max(y1, y2));
+
+    tags.clear();
+    AABBQueryCallback callback(aabb, &tags);
+    box2d_world_->QueryAABB(&callback, aabb);
+
+    for (size_t j = 0; j < tags.size(); j++) {
+      SetArrayNumber(state, results, count * 2 + 1, i + 1);
+      SetArrayNumber(state, results, count * 2 + 2, tags[j]);
+      count++;
+    }
+  }
+  return count;
+}
+
+int LevelLayer::OverlapCircle(int circles, int results) {
+  lua_State* state = lua_stack_->getLuaState();
+  int num_circles = lua_objlen(state, circles) / 3;
+  int count = 0;
+  std::vector<int> tags;
+  for (int i = 0; i < num_circles; i++) {
+    b2Vec2 center(GetArrayNumber(state, circles, i * 3 + 1),
+                  GetArrayNumber(state, circles, i * 3 + 2));
+    float radius = GetArrayNumber(state, circles, i * 3 + 3);
+    b2AABB aabb;
+    aabb.lowerBound = center - b2Vec2(radius, radius);
+    aabb.upperBound = center + b2Vec2(radius, radius);
+
+    tags.clear();
+    CircleQueryCallback callback(center, radius, &tags);
+    box2d_world_->QueryAABB(&callback, aabb);
+
+    for (size_t j = 0; j < tags.size(); j++) {
+      SetArrayNumber(state, results, count * 2 + 1, i + 1);
+      SetArrayNumber(state, results, count * 2 + 2, tags[j]);
+      count++;
+    }
+  }
+  return count;
+}
+
+int LevelLayer::RayCastBatch(int rays, int results) {
+  lua_State* state = lua_stack_->getLuaState();
+  int num_rays = lua_objlen(state, rays) / 4;
+  for (int i = 0; i < num_rays; i++) {
+    b2Vec2 start(GetArrayNumber(state, rays, i * 4 + 1),
+                 GetArrayNumber(state, rays, i * 4 + 2));
+    b2Vec2 end(GetArrayNumber(state, rays, i * 4 + 3),
+               GetArrayNumber(state, rays, i * 4 + 4));
+
+    ClosestRayCastCallback callback;
+    callback.point_ = end;
+    callback.normal_.SetZero();
+    // box2d asserts on zero length rays.
+    if ((end - start).LengthSquared() > 0.0f)
+      box2d_world_->RayCast(&callback, start, end);
+
+    int tag = 0;
+    if (callback.fixture_)
+      tag = TagForFixture(callback.fixture_);
+
+    int base = i * 6;
+    SetArrayNumber(state, results, base + 1, tag);
+    SetArrayNumber(state, results, base + 2, callback.point_.x);
+    SetArrayNumber(state, results, base + 3, callback.point_.y);
+    SetArrayNumber(state, results, base + 4, callback.normal_.x);
+    SetArrayNumber(state, results, base + 5, callback.normal_.y);
+    SetArrayNumber(state, results, base + 6, callback.fraction_);
+  }
+  return num_rays;
 }
@@ -7,6 +7,12 @@
 #include "cocos2d.h"
 #include "CCLuaStack.h"
 #include "Box2D/Box2D.h"
+#include "body_pair_table.h"
+#include "physics_governor.h"
+#include "trigger_grid.h"
+#include "world_pool.h"
+#include "world_snapshot.h"
+#include "worker_thread.h"
 
 #ifdef COCOS2D_DEBUG
 #ifndef WIN32
@@ -16,8 +22,30 @@
 
 USING_NS_CC;
 
+// Pixels-to-meters ratio for converting screen coordinates
+// to Box2D "meters".
+#define PTM_RATIO 32
+
+class PhysicsBodyNode;
+class StrokeBuilder;
+class WorldPreview;
+
 typedef std::vector<cocos2d::CCPoint> PointList;
 
+// A contact between two tagged bodies recorded during a physics step.
+struct ContactEvent {
+  int tag1;
+  int tag2;
+  bool began;
+};
+
+// The hardest impact between two tagged bodies during a frame.
+struct ImpactEvent {
+  int tag1;
+  int tag2;
+  float impulse;
+};
+
 /**
  * Lavel layer in which gameplay takes place.  This layer contains
  * the box2d world simulation.
@@ -33,37 +61,378 @@ class LevelLayer : public CCLayerColor,
   virtual bool init();
   virtual void draw();
 
+  // When threaded physics is enabled the physics step that was
+  // requested during update() runs on the worker thread while the
+  // layer's children are drawn.
+  virtual void visit();
+
+  // Called once per frame by the scheduler.  Steps the physics world
+  // (unless native stepping has been disabled) and then calls the lua
+  // post-step handler, if any.
+  virtual void update(float delta);
+
   b2World* GetWorld() { return box2d_world_; }
 
-  // Find all bodies at a given position and call the
-  // given lua_handler for each one.
-  void FindBodiesAt(b2Vec2* pos, int lua_handler);
+  // Return the tag of the object that a fixture belongs to.  Fixtures
+  // of the shared static body carry their own tag, all others take the
+  // tag of their body.
+  static int TagForFixture(b2Fixture* fixture);
+
+  // Shared static body to which the level's non-dynamic geometry and
+  // pivot joints are attached.  Created at the origin on first use.
+  b2Body* GetStaticBody();
+
+  // Set the tag of a fixture of the static body.
+  void SetFixtureTag(b2Fixture* fixture, int tag);
+
+  // Add edges to the static body.  'edges' is a flat lua array of
+  // (x1, y1, x2, y2, tag) in box2d world units.  Connected edges with
+  // the same tag are merged into a single chain shape.  Returns the
+  // number of fixtures created.
+  int AddStaticEdges(int edges);
+
+  // Add the boxes that make up static lines to the static body in one
+  // call.  'boxes' is a flat lua array of
+  // (x1, y1, x2, y2, half_thickness, tag) in box2d world units, each
+  // entry giving the ends of a line.  Returns the number of fixtures
+  // created.
+  int AddStaticBoxes(int boxes);
+
+  // Advance the physics simulation by 'delta' seconds.  The world is
+  // always stepped in fixed size increments; any remaining time is
+  // carried over to the next call and used to interpolate the rendered
+  // transforms of registered PhysicsBodyNodes.
+  void StepPhysics(float delta, int velocity_iterations,
+                   int position_iterations);
+
+  // Apply the settings from the 'physics' section of the game and level
+  // def files (see DEFAULT_PHYSICS in loader.lua).  This covers the world
+  // settings (gravity, sleeping, continuous collision, warm starting and
+  // sub-stepping) as well as everything set by the individual setters
+  // below.  Keys missing from the table keep their current values.
+  void ApplyPhysicsSettings(LUA_TABLE settings);
+
+  // Set the rate (in Hz) of the fixed physics step and the maximum
+  // number of steps that StepPhysics will run to catch up after a slow
+  // frame.
+  void SetPhysicsRate(float hz, int max_steps);
+
+  // Set the iteration counts used when the world is stepped from update().
+  void SetPhysicsIterations(int velocity_iterations, int position_iterations);
+
+  // Enable or disable stepping of the world from update().  When disabled
+  // the lua code is responsible for calling StepPhysics itself.
+  void SetNativeStep(bool enabled);
+
+  // While paused StepPhysics does nothing.
+  void SetPhysicsPaused(bool paused);
+
+  // Set the budget, in milliseconds, for the time spent stepping the
+  // world each frame.  While the measured step time is over budget the
+  // simulation quality is lowered (see PhysicsGovernor), and the lua
+  // OnPhysicsQualityChanged callback is told of each change.  Zero
+  // disables the governor.
+  void SetPhysicsBudget(float budget_ms);
+
+  // Current quality level chosen by the governor, where 0 is full
+  // quality.
+  int GetPhysicsQuality() { return governor_.GetLevel(); }
+
+  // Run the physics steps on a worker thread, overlapping them with
+  // rendering.  Nodes are drawn using the transforms from the previous
+  // step, and contacts are passed to lua on the main thread at the
+  // start of the next step.  Falls back to stepping on the main thread
+  // if the worker thread can't be started.
+  void SetThreadedPhysics(bool enabled);
+
+  // True while a threaded physics step may be running alongside the
+  // draw pass.  No body may be read until it has completed.
+  bool IsStepInFlight() const { return step_in_flight_; }
+
+  // Set the lua function to call each frame after the physics step.
+  void SetPostStepHandler(int lua_handler);
+
+  // Declare which contact events the object with the given tag has
+  // handlers for.  Contacts are only passed to lua if one of the two
+  // bodies (or the global interest) has registered interest.
+  void SetContactInterest(int tag, bool began, bool ended);
+
+  // Declare interest in contact events between all tagged bodies.
+  // By default all events are delivered.
+  void SetGlobalContactInterest(bool began, bool ended);
+
+  // Set the normal impulse at or above which contacts of the body with
+  // the given tag are reported to lua as impacts.  Zero, the default,
+  // disables impact reporting for the tag.
+  void SetImpactThreshold(int tag, float threshold);
+
+  // Set the impact threshold that applies to all tagged bodies.
+  void SetGlobalImpactThreshold(float threshold);
+
+  // Add a circular trigger volume, in world coordinates.  Triggers are
+  // not part of the box2d world; instead they are tested after each
+  // step against the trigger activators, and report activators passing
+  // through them as OnContactBegan / OnContactEnded events just like a
+  // sensor fixture would.  Adding a trigger with an existing tag moves
+  // it.
+  void AddTrigger(int tag, b2Vec2* center, float radius);
+  void RemoveTrigger(int tag);
+
+  // Mark the bodies with the given tag as trigger activators.  Only
+  // activators set off triggers.
+  void SetTriggerActivator(int tag, bool enabled);
+
+  // Called by PhysicsBodyNode when it is added to / removed from the
+  // layer.
+  void RegisterPhysicsNode(PhysicsBodyNode* node);
+  void UnregisterPhysicsNode(PhysicsBodyNode* node);
+
+  // Called by PhysicsBodyNode when its body is moved outside of the
+  // simulation.
+  void ResetPhysicsNode(PhysicsBodyNode* node);
+
+  // Find all tagged bodies at a given position and store their tags in
+  // the lua table at the given stack index (as an array).  Each body is
+  // reported once, no matter how many of its fixtures contain the point.
+  // If sort_by_draw_order is set the tags are ordered so that the body
+  // whose node is drawn on top comes first.  Returns the number of tags.
+  int FindBodiesAt(b2Vec2* pos, int lua_table, bool sort_by_draw_order);
+
+  // Batch query methods.  Each takes a flat lua array of queries and
+  // writes its results to a second (empty) lua array, returning the
+  // number of results.  All coordinates are in box2d world units.
+
+  // Find the tagged bodies overlapping each of the axis aligned boxes in
+  // 'regions' (x1, y1, x2, y2, ...).  Results are written as
+  // (query_index, tag) pairs.
+  int QueryRegion(int regions, int results);
+
+  // Find the tagged bodies overlapping each of the circles in 'circles'
+  // (x, y, radius, ...).  Results are written as (query_index, tag) pairs.
+  int OverlapCircle(int circles, int results);
+
+  // Find the closest non-sensor fixture along each of the rays in 'rays'
+  // (x1, y1, x2, y2, ...).  For each ray six values are written:
+  // tag, hit x, hit y, normal x, normal y and fraction.  If the ray hit
+  // nothing the tag is 0, the hit point is the end of the ray and the
+  // fraction is 1.  Returns the number of rays.
+  int RayCastBatch(int rays, int results);
+
+  // Simulate a copy of the world for 'steps' physics steps on a worker
+  // thread, for example to preview the path of an object.  The
+  // positions of the bodies with the tags listed in 'tags' are sampled
+  // every 'sample_interval' steps.  Once the simulation completes the
+  // handler is called from update() with a flat array of positions
+  // (x1, y1, x2, y2, ... for each tag in each sample) and the number of
+  // samples.  Starting a new preview cancels the previous one.
+  bool StartPreview(int tags, int steps, int sample_interval,
+                    int lua_handler);
+
+  // Cancel the running preview, if any.  Its handler will not be called.
+  void CancelPreview();
+
+  // Builder for the strokes that the user draws, created on first use.
+  StrokeBuilder* GetStrokeBuilder();
 
   void ToggleDebug();
   bool LoadLevel(int level_number);
 
+  // Restart the level in place by restoring the snapshot of the world
+  // taken when the level was loaded, and then calling the lua
+  // RestartLevel function.  Returns false if the level can't be
+  // restarted in place and needs to be recreated instead.  Lua's
+  // PrepareRestartLevel is asked before anything is changed.
+  bool RestoreSnapshot();
+
   // Called by box2d when contacts start
   void BeginContact(b2Contact* contact);
 
   // Called by box2d when contacts finish
   void EndContact(b2Contact* contact);
 
+  // Called by box2d with the impulses the solver applied to a contact.
+  void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse);
+
   // Methods that are exposed to / called by lua the lua
   // script.
   void LevelComplete();
 
  protected:
-  // Called by BeginContact and EndContact to nofify Lua code when box2d
-  // contacts start and finish.
-  void LuaNotifyContact(b2Contact* contact, const char* function_name);
+  // Called by BeginContact and EndContact to record contacts between
+  // tagged bodies.  Fixture level contacts are aggregated so that an
+  // event is only queued when the first fixture pair of two bodies
+  // starts touching or the last one stops.
+  void QueueContactEvent(b2Contact* contact, bool began);
+
+  // Deliver all queued contact events to lua in a single call to the
+  // OnContactEvents callback.
+  void DispatchContactEvents();
+
+  // Deliver the impacts recorded since the last call to lua in a single
+  // call to the OnContactImpulses callback.
+  void DispatchImpactEvents();
+
+  // Returns the lowest impact threshold of the two tags, or zero if
+  // neither has one.
+  float ImpactThreshold(int tag1, int tag2);
+
+  // Queue a contact event between two tags, unless no one is
+  // interested in it.
+  void QueueTagEvent(int tag1, int tag2, bool began);
+
+  // Test the trigger activators against the triggers and queue events
+  // for the overlaps that started or ended since the last call.
+  void CheckTriggers();
+  void UpdateTriggerActivators();
 
   bool LoadLua(int level_number);
 
   bool InitPhysics();
 
+  // Run as many fixed size steps as fit in the accumulated time.  This
+  // is called on the worker thread in threaded mode, so it must not
+  // touch anything other than the world, the previous_* arrays and the
+  // contact and trigger state.
+  void RunPhysicsSteps(int velocity_iterations, int position_iterations);
+
+  // Block until a physics step running on the worker thread completes.
+  void WaitForPhysics();
+
+  // Record the transforms of all moving bodies before a physics step.
+  void SavePhysicsState();
+
+  // Sync pass run once per frame after stepping.  Interpolates the
+  // transforms of the moving bodies and passes them to their nodes.
+  // Nodes whose bodies are asleep are not touched.
+  void InterpolatePhysicsState(float alpha);
+
+  // Bookkeeping run after every batch of physics steps, however they
+  // were run: syncs the nodes, updates the governor and records the
+  // world's size with the pool.
+  void FinishPhysicsSteps();
+
+  // Pass the results of a completed preview to its lua handler.
+  void DeliverPreview();
+
+  // Feed the time taken by the last physics steps to the governor and
+  // apply any change in quality.
+  void UpdateGovernor();
+  bool HasBulletBodies();
+
+  // Tell lua about a change in physics quality.
+  void ReportPhysicsQuality();
+
+  friend class PhysicsStepTask;
+
  private:
-  // Box2D physics world
+  // Box2D physics world, and the pool it came from and is returned to.
   b2World* box2d_world_;
+  WorldPool* world_pool_;
+
+  // Body shared by the level's static geometry, or NULL.
+  b2Body* static_body_;
+
+  // Length of a single physics step in seconds.
+  float physics_timestep_;
+
+  // Maximum number of physics steps to run in a single frame.
+  int max_physics_steps_;
+
+  // Simulation time not yet consumed by a physics step.
+  float physics_accumulator_;
+
+  // Physics nodes whose render transforms are updated after stepping,
+  // indexed by their physics slot.
+  std::vector<PhysicsBodyNode*> physics_nodes_;
+
+  // Body transforms before the last physics step, per physics slot.
+  std::vector<float32> previous_x_;
+  std::vector<float32> previous_y_;
+  std::vector<float32> previous_angle_;
+
+  // Set for slots whose body was moving at the last sync.
+  std::vector<uint8_t> slot_moving_;
+
+  // Scratch arrays used by the sync pass, holding only the moving
+  // bodies so that the interpolation runs over contiguous data.
+  std::vector<int> sync_slots_;
+  std::vector<float32> sync_x_;
+  std::vector<float32> sync_y_;
+  std::vector<float32> sync_angle_;
+
+  // Iteration counts used by the native physics step.
+  int velocity_iterations_;
+  int position_iterations_;
+
+  // True if update() should step the physics world.
+  bool native_step_;
+  bool physics_paused_;
+
+  // Whether continuous collision detection is enabled at full quality.
+  bool continuous_physics_;
+
+  // Governor which lowers the physics quality when stepping is slow,
+  // along with the time taken by the steps run since it was last
+  // updated.  Set once the quality has changed and lua hasn't yet been
+  // told.
+  PhysicsGovernor governor_;
+  float step_time_ms_;
+  int steps_run_;
+  bool quality_changed_;
+
+  // Worker thread used for threaded physics, or NULL.
+  WorkerThread* physics_thread_;
+  WorkerTask* physics_task_;
+
+  // Set by StepPhysics in threaded mode when steps are due to run
+  // during the next visit(), along with their iteration counts.
+  bool physics_pending_;
+  int pending_velocity_iterations_;
+  int pending_position_iterations_;
+  bool step_in_flight_;
+
+  // Lua handler called at the end of update().
+  int post_step_handler_;
+
+  // Speculative simulation started by StartPreview, and the lua
+  // handler to call with its results.
+  WorldPreview* preview_;
+  int preview_handler_;
+
+  StrokeBuilder* stroke_builder_;
+
+  // Contact events queued during the physics step.
+  std::vector<ContactEvent> contact_events_;
+
+  // Number of touching fixture pairs between each pair of tagged bodies.
+  BodyPairTable<int> contact_counts_;
+
+  // Trigger volumes, the nodes of the bodies that set them off (along
+  // with a flag for each activator tag), and the sorted
+  // (activator tag, trigger tag) pairs that overlapped after the last
+  // step.
+  TriggerGrid triggers_;
+  std::vector<PhysicsBodyNode*> trigger_activators_;
+  std::vector<uint8_t> trigger_activator_tags_;
+  std::vector<std::pair<int, int> > trigger_overlaps_;
+  // Scratch space for CheckTriggers.
+  std::vector<std::pair<int, int> > new_trigger_overlaps_;
+  std::vector<int> trigger_query_;
+
+  // Hardest impacts recorded since they were last passed to lua, and
+  // the index + 1 of the event for each pair of tags.
+  std::vector<ImpactEvent> impact_events_;
+  BodyPairTable<int> impact_indices_;
+
+  // Impact threshold for each tag and for all tags, and the number of
+  // tags with a threshold.
+  std::vector<float> impact_thresholds_;
+  float global_impact_threshold_;
+  int impact_threshold_count_;
+
+  // Bitmask of CONTACT_INTEREST_* flags for each tag, and for all tags.
+  std::vector<uint8_t> contact_interest_;
+  uint8_t global_contact_interest_;
 
 #ifdef COCOS2D_DEBUG
 #ifndef WIN32
@@ -75,6 +444,12 @@ class LevelLayer : public CCLayerColor,
   // Flag to enable drawing of Box2D debug data.
   bool debug_enabled_;
 
+  // Snapshot of the level state, taken just after loading.
+  WorldSnapshot snapshot_;
+
+  // Set once LevelComplete has been called.
+  bool level_complete_;
+
   CCLuaStack* lua_stack_;
 };
 
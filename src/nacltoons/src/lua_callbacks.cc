@@ -0,0 +1,104 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "lua_callbacks.h"
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+}
+
+// Names of the global lua functions, indexed by LuaCallback.
+static const char* kCallbackNames[LUA_CALLBACK_COUNT] = {
+  "LoadGame",
+  "LoadLevel",
+  "OnContactEvents",
+  "PrepareRestartLevel",
+  "RestartLevel",
+  "OnPhysicsQualityChanged",
+  "OnContactImpulses",
+};
+
+LuaCallbacks::LuaCallbacks() : lua_stack_(NULL) {
+  for (int i = 0; i < LUA_CALLBACK_COUNT; i++)
+    refs_[i] = LUA_NOREF;
+}
+
+LuaCallbacks::~LuaCallbacks() {
+  Release();
+}
+
+void LuaCallbacks::Release() {
+  if (!lua_stack_)
+    return;
+  lua_State* state = lua_stack_->getLuaState();
+  for (int i = 0; i < LUA_CALLBACK_COUNT; i++) {
+    luaL_unref(state, LUA_REGISTRYINDEX, refs_[i]);
+    refs_[i] = LUA_NOREF;
+  }
+}
+
+void LuaCallbacks::Refresh(CCLuaStack* lua_stack) {
+  Release();
+  lua_stack_ = lua_stack;
+  lua_State* state = lua_stack_->getLuaState();
+  for (int i = 0; i < LUA_CALLBACK_COUNT; i++) {
+    lua_getglobal(state, kCallbackNames[i]);
+    if (lua_isfunction(state, -1)) {
+      refs_[i] = luaL_ref(state, LUA_REGISTRYINDEX);
+    } else {
+      CCLog("lua callback not defined: %s", kCallbackNames[i]);
+      lua_pop(state, 1);
+    }
+  }
+}
+
+bool LuaCallbacks::Has(LuaCallback callback) const {
+  return refs_[callback] != LUA_NOREF;
+}
+
+bool LuaCallbacks::Push(LuaCallback callback) {
+  if (!Has(callback))
+    return false;
+  lua_rawgeti(lua_stack_->getLuaState(), LUA_REGISTRYINDEX, refs_[callback]);
+  return true;
+}
+
+int LuaCallbacks::Call(int num_args) {
+  // CCLuaStack only exposes calls by name or by script handler, so the
+  // call is made here, with the same error handling and return value
+  // conversion as CCLuaStack::executeFunctionByHandler.
+  lua_State* state = lua_stack_->getLuaState();
+  int function_index = -(num_args + 1);
+  if (!lua_isfunction(state, function_index)) {
+    CCLog("value at stack [%d] is not function", function_index);
+    lua_pop(state, num_args + 1);
+    return 0;
+  }
+
+  // Report errors with a stack trace if the scripts define a handler.
+  int traceback = 0;
+  lua_getglobal(state, "__G__TRACKBACK__");
+  if (lua_isfunction(state, -1)) {
+    lua_insert(state, function_index - 1);
+    traceback = function_index - 1;
+  } else {
+    lua_pop(state, 1);
+  }
+
+  if (lua_pcall(state, num_args, 1, traceback)) {
+    if (!traceback)
+      CCLog("[LUA ERROR] %s", lua_tostring(state, -1));
+    // Remove the error message and the traceback function.
+    lua_pop(state, traceback ? 2 : 1);
+    return 0;
+  }
+
+  int rtn = 0;
+  if (lua_isnumber(state, -1))
+    rtn = lua_tointeger(state, -1);
+  else if (lua_isboolean(state, -1))
+    rtn = lua_toboolean(state, -1);
+  lua_pop(state, traceback ? 2 : 1);
+  return rtn;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef LUA_CALLBACKS_H_
+#define LUA_CALLBACKS_H_
+
+#include "CCLuaStack.h"
+
+USING_NS_CC;
+
+/**
+ * Global lua functions that are called from C++.
+ */
+enum LuaCallback {
+  LUA_CALLBACK_LOAD_GAME,
+  LUA_CALLBACK_LOAD_LEVEL,
+  LUA_CALLBACK_CONTACT_EVENTS,
+  LUA_CALLBACK_PREPARE_RESTART_LEVEL,
+  LUA_CALLBACK_RESTART_LEVEL,
+  LUA_CALLBACK_PHYSICS_QUALITY,
+  LUA_CALLBACK_CONTACT_IMPULSES,
+  LUA_CALLBACK_COUNT
+};
+
+/**
+ * Registry of references to the global lua functions that the engine
+ * calls.  The globals are looked up by name once, in Refresh(), and
+ * stored in the lua registry so that calling them only requires a
+ * lua_rawgeti.
+ */
+class LuaCallbacks {
+ public:
+  LuaCallbacks();
+  ~LuaCallbacks();
+
+  // Look up all the callbacks by name.  This must be called again
+  // whenever the lua scripts that define them are (re)loaded.
+  void Refresh(CCLuaStack* lua_stack);
+
+  // Returns true if lua defined the given callback.
+  bool Has(LuaCallback callback) const;
+
+  // Push the given callback function onto the lua stack.  The caller
+  // should then push any arguments and call Call().  Returns false,
+  // without pushing anything, if the callback is not defined.
+  bool Push(LuaCallback callback);
+
+  // Call the function pushed by Push() with 'num_args' arguments.
+  // Returns the function's result as an integer (booleans are 0 or 1),
+  // or 0 if the call failed.
+  int Call(int num_args);
+
+ private:
+  void Release();
+
+  CCLuaStack* lua_stack_;
+  int refs_[LUA_CALLBACK_COUNT];
+};
+
+#endif  // LUA_CALLBACKS_H_
@@ -0,0 +1,105 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "physics_body_node.h"
+#include "level_layer.h"
+
+#include <assert.h>
+
+// Bodies must not be read while the level steps its world on the
+// physics thread, which overlaps with drawing.
+#define ASSERT_BODY_READABLE() \
+  assert(!level_layer_ || !level_layer_->IsStepInFlight())
+
+PhysicsBodyNode::PhysicsBodyNode()
+    : level_layer_(NULL),
+      physics_slot_(-1),
+      has_render_state_(false),
+      render_angle_(0) {
+}
+
+void PhysicsBodyNode::onEnter() {
+  CCPhysicsNode::onEnter();
+  ResetPhysicsState();
+  level_layer_ = dynamic_cast<LevelLayer*>(getParent());
+  if (level_layer_)
+    level_layer_->RegisterPhysicsNode(this);
+}
+
+void PhysicsBodyNode::onExit() {
+  if (level_layer_) {
+    level_layer_->UnregisterPhysicsNode(this);
+    level_layer_ = NULL;
+  }
+  CCPhysicsNode::onExit();
+}
+
+void PhysicsBodyNode::setPosition(const CCPoint& position) {
+  CCPhysicsNode::setPosition(position);
+  ResetPhysicsState();
+}
+
+void PhysicsBodyNode::setRotation(float rotation) {
+  CCPhysicsNode::setRotation(rotation);
+  ResetPhysicsState();
+}
+
+void PhysicsBodyNode::SetRenderState(float32 x, float32 y, float32 angle) {
+  render_position_.Set(x, y);
+  render_angle_ = angle;
+  has_render_state_ = true;
+  m_bTransformDirty = m_bInverseDirty = true;
+}
+
+void PhysicsBodyNode::ResetPhysicsState() {
+  ASSERT_BODY_READABLE();
+  b2Body* body = getB2Body();
+  if (!body) {
+    has_render_state_ = false;
+    return;
+  }
+  const b2Vec2& position = body->GetPosition();
+  SetRenderState(position.x, position.y, body->GetAngle());
+  if (level_layer_ && physics_slot_ >= 0)
+    level_layer_->ResetPhysicsNode(this);
+}
+
+CCAffineTransform PhysicsBodyNode::nodeToParentTransform() {
+  if (!has_render_state_) {
+    ASSERT_BODY_READABLE();
+    return CCPhysicsNode::nodeToParentTransform();
+  }
+
+  // The render state only changes when SetRenderState is called, which
+  // marks the transform dirty, as do the CCNode setters.
+  if (!m_bTransformDirty)
+    return m_sTransform;
+
+  // This mirrors CCPhysicsSprite::nodeToParentTransform but uses the
+  // interpolated render state in place of the live body transform.
+  float ptm_ratio = getPTMRatio();
+  float x = render_position_.x * ptm_ratio;
+  float y = render_position_.y * ptm_ratio;
+
+  if (m_bIgnoreAnchorPointForPosition) {
+    x += m_obAnchorPointInPoints.x;
+    y += m_obAnchorPointInPoints.y;
+  }
+
+  float c = cosf(render_angle_);
+  float s = sinf(render_angle_);
+
+  if (!m_obAnchorPointInPoints.equals(CCPointZero)) {
+    x += c * -m_obAnchorPointInPoints.x * m_fScaleX +
+         -s * -m_obAnchorPointInPoints.y * m_fScaleY;
+    y += s * -m_obAnchorPointInPoints.x * m_fScaleX +
+         c * -m_obAnchorPointInPoints.y * m_fScaleY;
+  }
+
+  m_sTransform = CCAffineTransformMake(c * m_fScaleX, s * m_fScaleX,
+                                       -s * m_fScaleY, c * m_fScaleY,
+                                       x, y);
+  m_bTransformDirty = false;
+  return m_sTransform;
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef PHYSICS_BODY_NODE_H_
+#define PHYSICS_BODY_NODE_H_
+
+#include "cocos2d.h"
+#include "physics_nodes/CCPhysicsNode.h"
+#include "Box2D/Box2D.h"
+
+USING_NS_CC;
+USING_NS_CC_EXT;
+
+class LevelLayer;
+
+/**
+ * Physics node which renders its box2d body at an interpolated
+ * transform rather than at the raw body transform.  When the node is
+ * added to a LevelLayer it registers itself so that the layer can
+ * update the render transform after each (fixed size) physics step.
+ * The transform is only recomputed when the layer reports that the
+ * render state changed, so nodes whose bodies are asleep cost nothing.
+ */
+class PhysicsBodyNode : public CCPhysicsNode {
+ public:
+  PhysicsBodyNode();
+
+  CREATE_FUNC(PhysicsBodyNode);
+
+  virtual void onEnter();
+  virtual void onExit();
+
+  virtual CCAffineTransform nodeToParentTransform();
+  virtual void setPosition(const CCPoint& position);
+  virtual void setRotation(float rotation);
+
+  // Set the transform at which the body is drawn and mark the node's
+  // transform as dirty.  Called by the LevelLayer's sync pass.
+  void SetRenderState(float32 x, float32 y, float32 angle);
+
+  // Snap both the previous and render state to the current body
+  // transform.  Used when the body is moved outside of the simulation.
+  void ResetPhysicsState();
+
+  // Index of the node's state in the LevelLayer's physics arrays, or -1
+  // if the node is not registered.
+  int GetPhysicsSlot() const { return physics_slot_; }
+  void SetPhysicsSlot(int slot) { physics_slot_ = slot; }
+
+ private:
+  LevelLayer* level_layer_;
+  int physics_slot_;
+  bool has_render_state_;
+  b2Vec2 render_position_;
+  float32 render_angle_;
+};
+
+#endif  // PHYSICS_BODY_NODE_H_
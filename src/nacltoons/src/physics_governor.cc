@@ -0,0 +1,97 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "physics_governor.h"
+
+#include <algorithm>
+
+// Quality is raised again once the average step time falls below this
+// fraction of the budget.  Keeping this well below 1 stops the governor
+// from flipping between two levels.
+#define HEADROOM_FRACTION 0.5f
+
+// Fewest iterations the governor will reduce the solver to.
+#define MIN_VELOCITY_ITERATIONS 2
+#define MIN_POSITION_ITERATIONS 1
+
+PhysicsGovernor::PhysicsGovernor()
+    : budget_ms_(0),
+      velocity_iterations_(8),
+      position_iterations_(1),
+      level_(0),
+      average_ms_(0) {
+  ResetWindow();
+}
+
+void PhysicsGovernor::SetBudget(float budget_ms) {
+  budget_ms_ = budget_ms;
+  level_ = 0;
+  ResetWindow();
+}
+
+void PhysicsGovernor::SetIterations(int velocity_iterations,
+                                    int position_iterations) {
+  velocity_iterations_ = velocity_iterations;
+  position_iterations_ = position_iterations;
+}
+
+int PhysicsGovernor::GetVelocityIterations() const {
+  int level = std::min(level_, (int)kIterationLevels);
+  int iterations = velocity_iterations_ -
+      level * (velocity_iterations_ - MIN_VELOCITY_ITERATIONS) /
+      kIterationLevels;
+  return std::max(std::min(iterations, velocity_iterations_),
+                  MIN_VELOCITY_ITERATIONS);
+}
+
+int PhysicsGovernor::GetPositionIterations() const {
+  int level = std::min(level_, (int)kIterationLevels);
+  int iterations = position_iterations_ - level;
+  return std::max(std::min(iterations, position_iterations_),
+                  MIN_POSITION_ITERATIONS);
+}
+
+void PhysicsGovernor::ResetWindow() {
+  sample_count_ = 0;
+  next_sample_ = 0;
+}
+
+bool PhysicsGovernor::AddSample(float step_ms, bool allow_no_ccd) {
+  if (!IsEnabled())
+    return false;
+
+  // A bullet body may have been created since CCD was turned off.
+  if (!allow_no_ccd && level_ > kIterationLevels) {
+    level_ = kIterationLevels;
+    ResetWindow();
+    return true;
+  }
+
+  samples_[next_sample_] = step_ms;
+  next_sample_ = (next_sample_ + 1) % kWindowSize;
+  if (sample_count_ < kWindowSize)
+    sample_count_++;
+
+  float total = 0;
+  for (int i = 0; i < sample_count_; i++)
+    total += samples_[i];
+  average_ms_ = total / sample_count_;
+
+  if (sample_count_ < kWindowSize)
+    return false;
+
+  int max_level = allow_no_ccd ? kIterationLevels + 1 : kIterationLevels;
+  int new_level = level_;
+  if (average_ms_ > budget_ms_ && level_ < max_level)
+    new_level++;
+  else if (average_ms_ < budget_ms_ * HEADROOM_FRACTION && level_ > 0)
+    new_level--;
+
+  if (new_level == level_)
+    return false;
+
+  // Measure the new level from scratch.
+  level_ = new_level;
+  ResetWindow();
+  return true;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef PHYSICS_GOVERNOR_H_
+#define PHYSICS_GOVERNOR_H_
+
+/**
+ * Adjusts the quality of the physics simulation to keep the time spent
+ * stepping the world within a budget.  The governor is fed the measured
+ * step time of each frame and keeps a rolling average of it.  When the
+ * average goes over budget the quality is lowered one level: first by
+ * reducing the solver iterations and, as a last resort, by turning off
+ * continuous collision detection.  When there is plenty of headroom the
+ * quality is raised again.
+ */
+class PhysicsGovernor {
+ public:
+  PhysicsGovernor();
+
+  // Set the budget for the time spent stepping each frame, in
+  // milliseconds.  A budget of zero disables the governor and restores
+  // full quality.
+  void SetBudget(float budget_ms);
+  float GetBudget() const { return budget_ms_; }
+  bool IsEnabled() const { return budget_ms_ > 0; }
+
+  // Set the iteration counts used at full quality.
+  void SetIterations(int velocity_iterations, int position_iterations);
+
+  // Record the time spent stepping during one frame.  'allow_no_ccd'
+  // says whether continuous collision detection may be turned off (it
+  // can't be while there are bullet bodies).  Returns true if the
+  // quality level changed.
+  bool AddSample(float step_ms, bool allow_no_ccd);
+
+  // Returns true if AddSample may lower the quality to the level at
+  // which continuous collision detection is turned off.
+  bool AtLowestIterations() const { return level_ >= kIterationLevels; }
+
+  // Quality level, where 0 is full quality.
+  int GetLevel() const { return level_; }
+  int GetVelocityIterations() const;
+  int GetPositionIterations() const;
+  bool GetContinuousPhysics() const { return level_ <= kIterationLevels; }
+  float GetAverage() const { return average_ms_; }
+
+ private:
+  enum {
+    // Number of levels at which the iterations are reduced.
+    kIterationLevels = 3,
+    // Number of frames averaged before the quality is changed.
+    kWindowSize = 30
+  };
+
+  void ResetWindow();
+
+  float budget_ms_;
+  int velocity_iterations_;
+  int position_iterations_;
+  int level_;
+  float samples_[kWindowSize];
+  int sample_count_;
+  int next_sample_;
+  float average_ms_;
+};
+
+#endif  // PHYSICS_GOVERNOR_H_
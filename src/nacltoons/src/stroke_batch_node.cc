@@ -0,0 +1,173 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "stroke_batch_node.h"
+#include "stroke_node.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+StrokeBatchNode::StrokeBatchNode()
+    : texture_(NULL),
+      layout_dirty_(false),
+      vertex_buffer_(0) {
+}
+
+StrokeBatchNode::~StrokeBatchNode() {
+  // Strokes unregister when they exit, which happens before the batch
+  // can be released.
+  assert(strokes_.empty());
+  if (vertex_buffer_)
+    glDeleteBuffers(1, &vertex_buffer_);
+  CC_SAFE_RELEASE(texture_);
+}
+
+StrokeBatchNode* StrokeBatchNode::create(const char* image) {
+  CCTexture2D* texture =
+      CCTextureCache::sharedTextureCache()->addImage(image);
+  StrokeBatchNode* node = new StrokeBatchNode();
+  if (node && node->initWithTexture(texture)) {
+    node->autorelease();
+    return node;
+  }
+  delete node;
+  return NULL;
+}
+
+bool StrokeBatchNode::initWithTexture(CCTexture2D* texture) {
+  if (!CCNode::init() || !texture)
+    return false;
+  texture_ = texture;
+  texture_->retain();
+
+  if (texture_->hasPremultipliedAlpha()) {
+    blend_func_.src = GL_ONE;
+    blend_func_.dst = GL_ONE_MINUS_SRC_ALPHA;
+  } else {
+    blend_func_.src = GL_SRC_ALPHA;
+    blend_func_.dst = GL_ONE_MINUS_SRC_ALPHA;
+  }
+
+  setShaderProgram(CCShaderCache::sharedShaderCache()->programForKey(
+      kCCShader_PositionTextureColor));
+  glGenBuffers(1, &vertex_buffer_);
+  return true;
+}
+
+void StrokeBatchNode::AddStroke(StrokeNode* stroke) {
+  StrokeEntry entry;
+  entry.stroke = stroke;
+  entry.version = 0;
+  entry.visible = false;
+  entry.first_vertex = 0;
+  entry.vertex_count = 0;
+  strokes_.push_back(entry);
+  layout_dirty_ = true;
+}
+
+void StrokeBatchNode::RemoveStroke(StrokeNode* stroke) {
+  for (size_t i = 0; i < strokes_.size(); i++) {
+    if (strokes_[i].stroke == stroke) {
+      strokes_.erase(strokes_.begin() + i);
+      layout_dirty_ = true;
+      return;
+    }
+  }
+}
+
+bool StrokeBatchNode::IsStrokeVisible(StrokeNode* stroke) {
+  for (CCNode* node = stroke; node; node = node->getParent()) {
+    if (!node->isVisible())
+      return false;
+  }
+  return true;
+}
+
+void StrokeBatchNode::WriteStroke(StrokeEntry* entry) {
+  const std::vector<ccV2F_C4B_T2F>& source = entry->stroke->GetVertices();
+  ccV2F_C4B_T2F* dest = &vertices_[entry->first_vertex];
+  for (size_t i = 0; i < source.size(); i++) {
+    const ccV2F_C4B_T2F& vertex = source[i];
+    CCPoint pos = CCPointApplyAffineTransform(
+        CCPoint(vertex.vertices.x, vertex.vertices.y), entry->transform);
+    dest[i + 1] = vertex;
+    dest[i + 1].vertices = vertex2(pos.x, pos.y);
+  }
+  // Repeat the first and last vertex so that the strips of neighbouring
+  // strokes are joined by degenerate triangles.
+  dest[0] = dest[1];
+  dest[source.size() + 1] = dest[source.size()];
+}
+
+void StrokeBatchNode::draw() {
+  CCAffineTransform world_to_batch = worldToNodeTransform();
+
+  // Lay out the vertex ranges again if strokes were added or removed,
+  // or if any stroke changed its number of vertices or its visibility.
+  bool relayout = layout_dirty_;
+  for (size_t i = 0; i < strokes_.size(); i++) {
+    StrokeEntry& entry = strokes_[i];
+    bool visible = IsStrokeVisible(entry.stroke) &&
+                   !entry.stroke->GetVertices().empty();
+    int count = visible ? entry.stroke->GetVertices().size() + 2 : 0;
+    if (visible != entry.visible || count != entry.vertex_count) {
+      entry.visible = visible;
+      entry.vertex_count = count;
+      relayout = true;
+    }
+  }
+
+  if (relayout) {
+    int total = 0;
+    for (size_t i = 0; i < strokes_.size(); i++) {
+      strokes_[i].first_vertex = total;
+      total += strokes_[i].vertex_count;
+    }
+    vertices_.resize(total);
+    layout_dirty_ = false;
+  }
+
+  bool upload = relayout;
+  for (size_t i = 0; i < strokes_.size(); i++) {
+    StrokeEntry& entry = strokes_[i];
+    if (!entry.visible)
+      continue;
+    CCAffineTransform transform = CCAffineTransformConcat(
+        entry.stroke->nodeToWorldTransform(), world_to_batch);
+    if (relayout || entry.version != entry.stroke->GetVersion() ||
+        !CCAffineTransformEqualToTransform(transform, entry.transform)) {
+      entry.transform = transform;
+      entry.version = entry.stroke->GetVersion();
+      WriteStroke(&entry);
+      upload = true;
+    }
+  }
+
+  if (vertices_.empty())
+    return;
+
+  CC_NODE_DRAW_SETUP();
+  ccGLBlendFunc(blend_func_.src, blend_func_.dst);
+  ccGLBindTexture2D(texture_->getName());
+  ccGLEnableVertexAttribs(kCCVertexAttribFlag_PosColorTex);
+
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_);
+  if (upload) {
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ccV2F_C4B_T2F) * vertices_.size(),
+                 &vertices_[0], GL_DYNAMIC_DRAW);
+  }
+  glVertexAttribPointer(kCCVertexAttrib_Position, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(ccV2F_C4B_T2F),
+                        (GLvoid*)offsetof(ccV2F_C4B_T2F, vertices));
+  glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+                        sizeof(ccV2F_C4B_T2F),
+                        (GLvoid*)offsetof(ccV2F_C4B_T2F, colors));
+  glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(ccV2F_C4B_T2F),
+                        (GLvoid*)offsetof(ccV2F_C4B_T2F, texCoords));
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices_.size());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  CC_INCREMENT_GL_DRAWS(1);
+  CHECK_GL_ERROR_DEBUG();
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef STROKE_BATCH_NODE_H_
+#define STROKE_BATCH_NODE_H_
+
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+class StrokeNode;
+
+/**
+ * Node that draws every StrokeNode that uses it in a single draw call.
+ * The strips of the strokes are transformed into the batch node's
+ * space and joined with degenerate triangles in one vertex buffer.  A
+ * stroke's vertices are only rewritten when its geometry or transform
+ * changes, and the buffer is only uploaded when something was
+ * rewritten.
+ */
+class StrokeBatchNode : public CCNode {
+ public:
+  StrokeBatchNode();
+  ~StrokeBatchNode();
+
+  // Create a batch that draws its strokes with the given brush image.
+  static StrokeBatchNode* create(const char* image);
+  bool initWithTexture(CCTexture2D* texture);
+
+  virtual void draw();
+
+  CCTexture2D* getTexture() { return texture_; }
+
+  // Called by StrokeNode when it enters and exits the scene.
+  void AddStroke(StrokeNode* stroke);
+  void RemoveStroke(StrokeNode* stroke);
+
+ private:
+  struct StrokeEntry {
+    StrokeNode* stroke;
+    // The state from which the stroke's vertices were last written.
+    CCAffineTransform transform;
+    unsigned version;
+    bool visible;
+    // Range of the stroke's vertices in vertices_, including the two
+    // repeated vertices that join it to its neighbours.
+    int first_vertex;
+    int vertex_count;
+  };
+
+  // Returns true if the stroke and all of its ancestors are visible.
+  bool IsStrokeVisible(StrokeNode* stroke);
+  void WriteStroke(StrokeEntry* entry);
+
+  CCTexture2D* texture_;
+  ccBlendFunc blend_func_;
+  std::vector<StrokeEntry> strokes_;
+  std::vector<ccV2F_C4B_T2F> vertices_;
+  // Set when strokes are added or removed, so that the vertex ranges
+  // need to be laid out again.
+  bool layout_dirty_;
+  GLuint vertex_buffer_;
+};
+
+#endif  // STROKE_BATCH_NODE_H_
@@ -0,0 +1,204 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "stroke_builder.h"
+
+#include <stdint.h>
+#include <math.h>
+
+#include "level_layer.h"
+#include "physics_body_node.h"
+#include "stroke_batch_node.h"
+#include "stroke_geometry.h"
+#include "stroke_node.h"
+
+// Collision category of finished drawn shapes.  This must match
+// MAIN_CATEGORY in drawing.lua.
+#define MAIN_CATEGORY 0x1
+
+// Default tolerance of the collision geometry simplification, as a
+// fraction of the brush's half width.
+#define DEFAULT_SIMPLIFY_TOLERANCE 0.5f
+
+// Smallest area, in squared half widths, of the inside of a closed
+// stroke that is made solid, and of the convex pieces of a stroke.
+#define MIN_CLOSED_AREA 16.0f
+#define MIN_POLYGON_AREA 0.01f
+
+// Tag of the stroke node within a shape's node, as in drawing.lua.
+#define TAG_STROKE_NODE 0x1
+
+StrokeBuilder::StrokeBuilder(LevelLayer* layer)
+    : layer_(layer),
+      batch_(NULL),
+      half_width_(0),
+      color_(ccWHITE),
+      simplify_tolerance_(DEFAULT_SIMPLIFY_TOLERANCE),
+      finish_mode_(FINISH_CONVEX),
+      fixture_count_(0),
+      unsimplified_fixture_count_(0),
+      node_(NULL),
+      stroke_(NULL) {
+}
+
+StrokeBuilder::~StrokeBuilder() {
+  CC_SAFE_RELEASE(batch_);
+}
+
+void StrokeBuilder::SetBrush(StrokeBatchNode* batch, float half_width) {
+  CC_SAFE_RETAIN(batch);
+  CC_SAFE_RELEASE(batch_);
+  batch_ = batch;
+  half_width_ = half_width;
+}
+
+b2Vec2 StrokeBuilder::ToBodySpace(const CCPoint& pos) {
+  // The node doesn't move while the stroke is drawn, so node space is
+  // the body's local space scaled by PTM_RATIO.
+  return b2Vec2(pos.x / PTM_RATIO, pos.y / PTM_RATIO);
+}
+
+void StrokeBuilder::AddFixture(const b2Shape& shape) {
+  b2FixtureDef fixture_def;
+  fixture_def.shape = &shape;
+  fixture_def.density = 1.0f;
+  fixture_def.friction = 0.5f;
+  fixture_def.restitution = 0.3f;
+  fixture_def.filter.categoryBits = MAIN_CATEGORY;
+  fixture_def.filter.maskBits = MAIN_CATEGORY;
+  node_->getB2Body()->CreateFixture(&fixture_def);
+  fixture_count_++;
+}
+
+void StrokeBuilder::AddEndPoint(const b2Vec2& pos) {
+  b2CircleShape sphere;
+  sphere.m_radius = half_width_ / PTM_RATIO;
+  sphere.m_p = pos;
+  AddFixture(sphere);
+}
+
+void StrokeBuilder::AddLine(const b2Vec2& from, const b2Vec2& to) {
+  b2Vec2 delta = to - from;
+  b2PolygonShape box;
+  box.SetAsBox(delta.Length() / 2, half_width_ / PTM_RATIO,
+               from + 0.5f * delta, atan2f(delta.y, delta.x));
+  AddFixture(box);
+}
+
+void StrokeBuilder::AddConvexPieces(const Polyline& path, float tolerance) {
+  float half_width = half_width_ / PTM_RATIO;
+  std::vector<Polyline> polygons;
+
+  // A stroke that ends where it started is closed, and if it encloses
+  // enough area its inside is made solid.  The outline is then drawn
+  // all the way round.
+  bool closed = false;
+  if (path.size() >= 4 &&
+      b2Distance(path.front(), path.back()) <= half_width * 2) {
+    Polyline outline(path.begin(), path.end() - 1);
+    float min_area = MIN_CLOSED_AREA * half_width * half_width;
+    if (fabsf(PolygonArea(outline)) > min_area &&
+        DecomposePolygon(outline, &polygons)) {
+      outline.push_back(outline.front());
+      DecomposeThickPolyline(outline, half_width, tolerance, &polygons);
+      closed = true;
+    }
+  }
+  if (!closed)
+    DecomposeThickPolyline(path, half_width, tolerance, &polygons);
+
+  for (size_t i = 0; i < polygons.size(); i++) {
+    const Polyline& polygon = polygons[i];
+    // Box2D can't compute the mass of slivers.
+    if (polygon.size() < 3 ||
+        PolygonArea(polygon) < MIN_POLYGON_AREA * half_width * half_width)
+      continue;
+    b2PolygonShape shape;
+    shape.Set(&polygon[0], polygon.size());
+    AddFixture(shape);
+  }
+}
+
+PhysicsBodyNode* StrokeBuilder::Begin(int tag, float x, float y) {
+  assert(batch_ && "SetBrush not called");
+  assert(!node_ && "stroke already started");
+
+  b2BodyDef body_def;
+  b2Body* body = layer_->GetWorld()->CreateBody(&body_def);
+  body->SetUserData((void*)(intptr_t)tag);
+
+  node_ = PhysicsBodyNode::create();
+  node_->setB2Body(body);
+  node_->setPTMRatio(PTM_RATIO);
+  node_->setPosition(ccp(x, y));
+  node_->setTag(tag);
+  layer_->addChild(node_, 1, tag);
+
+  stroke_ = StrokeNode::create(batch_, half_width_);
+  node_->addChild(stroke_, 1, TAG_STROKE_NODE);
+  stroke_->MoveTo(0, 0, color_);
+
+  points_.clear();
+  points_.push_back(b2Vec2_zero);
+  last_sample_ = b2Vec2_zero;
+  return node_;
+}
+
+bool StrokeBuilder::Append(float x, float y) {
+  if (!node_)
+    return false;
+  CCPoint sample = node_->convertToNodeSpace(ccp(x, y));
+  last_sample_ = ToBodySpace(sample);
+  if (b2Distance(points_.back(), last_sample_) <=
+      half_width_ * 2 / PTM_RATIO)
+    return false;
+  points_.push_back(last_sample_);
+  stroke_->LineTo(sample.x, sample.y, color_);
+  return true;
+}
+
+PhysicsBodyNode* StrokeBuilder::End() {
+  PhysicsBodyNode* node = node_;
+  if (!node)
+    return NULL;
+
+  if (b2Distance(points_.back(), last_sample_) > half_width_ / PTM_RATIO)
+    points_.push_back(last_sample_);
+  stroke_->LineTo(last_sample_.x * PTM_RATIO, last_sample_.y * PTM_RATIO,
+                  color_);
+
+  // The mesh keeps every point, but the collision geometry only needs
+  // to follow the stroke to within a fraction of the brush width.  This
+  // removes the many nearly collinear lines of a slow stroke.
+  float tolerance = simplify_tolerance_ * half_width_ / PTM_RATIO;
+  Polyline simplified;
+  SimplifyPolyline(points_, tolerance, &simplified);
+
+  fixture_count_ = 0;
+  AddEndPoint(simplified.front());
+  if (finish_mode_ == FINISH_CONVEX) {
+    AddConvexPieces(simplified, tolerance);
+  } else {
+    for (size_t i = 1; i < simplified.size(); i++)
+      AddLine(simplified[i - 1], simplified[i]);
+  }
+  AddEndPoint(last_sample_);
+  // One box per line plus the two end points.
+  unsimplified_fixture_count_ = points_.size() - 1 + 2;
+  node->getB2Body()->SetType(b2_dynamicBody);
+
+  node_ = NULL;
+  stroke_ = NULL;
+  return node;
+}
+
+void StrokeBuilder::Cancel() {
+  if (!node_)
+    return;
+  b2Body* body = node_->getB2Body();
+  node_->removeFromParentAndCleanup(true);
+  body->GetWorld()->DestroyBody(body);
+  node_ = NULL;
+  stroke_ = NULL;
+  points_.clear();
+}
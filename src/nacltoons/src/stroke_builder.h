@@ -0,0 +1,102 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef STROKE_BUILDER_H_
+#define STROKE_BUILDER_H_
+
+#include "cocos2d.h"
+#include "Box2D/Box2D.h"
+#include "stroke_geometry.h"
+
+USING_NS_CC;
+
+class LevelLayer;
+class PhysicsBodyNode;
+class StrokeBatchNode;
+class StrokeNode;
+
+/**
+ * Builds freehand strokes as the user draws them.  Each touch sample
+ * is a single call, and the builder does the spacing of the samples
+ * and extends the stroke's mesh without going through lua.  The body
+ * has no fixtures while the stroke is drawn, so it doesn't disturb the
+ * level.  End() simplifies the stroke, adds its fixtures and makes the
+ * body dynamic.
+ */
+class StrokeBuilder {
+ public:
+  // How End() turns a stroke into fixtures.
+  enum FinishMode {
+    // A box for each line of the simplified stroke.
+    FINISH_BOXES,
+    // The thick stroke split into as few convex polygons as possible.
+    // Closed strokes are also filled in.
+    FINISH_CONVEX
+  };
+
+  explicit StrokeBuilder(LevelLayer* layer);
+  ~StrokeBuilder();
+
+  // Set the batch that draws the strokes and half the width of the
+  // brush, in points.
+  void SetBrush(StrokeBatchNode* batch, float half_width);
+  void SetColor(const ccColor3B& color) { color_ = color; }
+
+  // Set how far the collision geometry of a stroke may stray from the
+  // drawn path, as a fraction of the brush's half width.  0 turns the
+  // simplification off.
+  void SetSimplifyTolerance(float tolerance) {
+    simplify_tolerance_ = tolerance;
+  }
+
+  void SetFinishMode(int mode) { finish_mode_ = (FinishMode)mode; }
+
+  // Start a stroke at the given point.  Returns the new node, which
+  // has been added to the layer with the given tag.
+  PhysicsBodyNode* Begin(int tag, float x, float y);
+
+  // Add a touch sample to the stroke.  A line is only added once the
+  // sample is at least a brush width away from the end of the stroke.
+  // Returns true if a line was added.
+  bool Append(float x, float y);
+
+  // Finish the stroke at the last sample and return its node.
+  PhysicsBodyNode* End();
+
+  // Abandon the stroke being drawn, removing its node and body.
+  void Cancel();
+
+  bool IsBuilding() const { return node_ != NULL; }
+
+  // Number of fixtures of the last finished stroke, and the number it
+  // would have had with a box for each line and no simplification.
+  int GetFixtureCount() const { return fixture_count_; }
+  int GetUnsimplifiedFixtureCount() const {
+    return unsimplified_fixture_count_;
+  }
+
+ private:
+  b2Vec2 ToBodySpace(const CCPoint& pos);
+  void AddFixture(const b2Shape& shape);
+  void AddLine(const b2Vec2& from, const b2Vec2& to);
+  void AddEndPoint(const b2Vec2& pos);
+  void AddConvexPieces(const Polyline& path, float tolerance);
+
+  LevelLayer* layer_;
+  StrokeBatchNode* batch_;
+  float half_width_;
+  ccColor3B color_;
+  float simplify_tolerance_;
+  FinishMode finish_mode_;
+  int fixture_count_;
+  int unsimplified_fixture_count_;
+
+  // State of the stroke being drawn.  The points are in the body's
+  // local space.
+  PhysicsBodyNode* node_;
+  StrokeNode* stroke_;
+  Polyline points_;
+  b2Vec2 last_sample_;
+};
+
+#endif  // STROKE_BUILDER_H_
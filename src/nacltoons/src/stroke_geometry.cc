@@ -0,0 +1,334 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "stroke_geometry.h"
+
+#include <algorithm>
+#include <math.h>
+#include <utility>
+
+// Returns the squared distance from point 'p' to the segment a-b.
+static float SegmentDistanceSquared(const b2Vec2& p, const b2Vec2& a,
+                                    const b2Vec2& b) {
+  b2Vec2 ab = b - a;
+  float length_squared = ab.LengthSquared();
+  if (length_squared < b2_epsilon)
+    return (p - a).LengthSquared();
+  float t = b2Clamp(b2Dot(p - a, ab) / length_squared, 0.0f, 1.0f);
+  return (p - (a + t * ab)).LengthSquared();
+}
+
+void SimplifyPolyline(const Polyline& points, float tolerance,
+                      Polyline* result) {
+  result->clear();
+  int count = points.size();
+  if (count <= 2 || tolerance <= 0) {
+    *result = points;
+    return;
+  }
+
+  // Split ranges at their furthest point until every point is within
+  // the tolerance of its range.  A stack is used rather than recursion
+  // since a long stroke can have a lot of points.
+  std::vector<bool> keep(count, false);
+  keep[0] = keep[count - 1] = true;
+  std::vector<std::pair<int, int> > ranges;
+  ranges.push_back(std::make_pair(0, count - 1));
+  float tolerance_squared = tolerance * tolerance;
+  while (!ranges.empty()) {
+    int first = ranges.back().first;
+    int last = ranges.back().second;
+    ranges.pop_back();
+
+    int furthest = -1;
+    float max_distance = tolerance_squared;
+    for (int i = first + 1; i < last; i++) {
+      float distance =
+          SegmentDistanceSquared(points[i], points[first], points[last]);
+      if (distance > max_distance) {
+        max_distance = distance;
+        furthest = i;
+      }
+    }
+    if (furthest < 0)
+      continue;
+    keep[furthest] = true;
+    ranges.push_back(std::make_pair(first, furthest));
+    ranges.push_back(std::make_pair(furthest, last));
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (keep[i])
+      result->push_back(points[i]);
+  }
+}
+
+float PolygonArea(const Polyline& polygon) {
+  float area = 0;
+  int count = polygon.size();
+  for (int i = 0; i < count; i++)
+    area += b2Cross(polygon[i], polygon[(i + 1) % count]);
+  return area / 2;
+}
+
+static bool LessXY(const b2Vec2& a, const b2Vec2& b) {
+  return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+void ConvexHull(const Polyline& points, Polyline* hull) {
+  // Andrew's monotone chain.
+  Polyline sorted(points);
+  std::sort(sorted.begin(), sorted.end(), LessXY);
+  int count = sorted.size();
+  hull->assign(count * 2, b2Vec2_zero);
+  int size = 0;
+  for (int i = 0; i < count; i++) {
+    while (size >= 2 && b2Cross((*hull)[size - 1] - (*hull)[size - 2],
+                                sorted[i] - (*hull)[size - 2]) <= 0)
+      size--;
+    (*hull)[size++] = sorted[i];
+  }
+  for (int i = count - 2, lower = size + 1; i >= 0; i--) {
+    while (size >= lower && b2Cross((*hull)[size - 1] - (*hull)[size - 2],
+                                    sorted[i] - (*hull)[size - 2]) <= 0)
+      size--;
+    (*hull)[size++] = sorted[i];
+  }
+  // The last point is the same as the first.
+  hull->resize(std::max(size - 1, 0));
+}
+
+// Returns the unit normal (to the left) of the line from a to b.
+static b2Vec2 LineNormal(const b2Vec2& a, const b2Vec2& b) {
+  b2Vec2 normal = b2Cross(1.0f, b - a);
+  normal.Normalize();
+  return normal;
+}
+
+// Write the outline of the thick polyline points[first, last]: the
+// left side forwards and then the right side backwards.
+static void ThickOutline(const Polyline& points, int first, int last,
+                         float half_width, Polyline* outline) {
+  const float kMaxMiterScale = 2.0f;
+  int count = last - first + 1;
+  outline->resize(count * 2);
+  for (int i = first; i <= last; i++) {
+    b2Vec2 offset;
+    if (i == first) {
+      offset = LineNormal(points[i], points[i + 1]);
+    } else if (i == last) {
+      offset = LineNormal(points[i - 1], points[i]);
+    } else {
+      // Push the sides out at the joints so that the width is kept.
+      b2Vec2 in = LineNormal(points[i - 1], points[i]);
+      b2Vec2 sum = in + LineNormal(points[i], points[i + 1]);
+      float length = sum.Normalize();
+      if (length < b2_epsilon)
+        sum = in;
+      offset = (1.0f / std::max(b2Dot(sum, in), 1.0f / kMaxMiterScale)) * sum;
+    }
+    offset *= half_width;
+    (*outline)[i - first] = points[i] + offset;
+    (*outline)[count * 2 - 1 - (i - first)] = points[i] - offset;
+  }
+}
+
+// Returns the angle by which the polyline turns at b, positive if it
+// turns left.
+static float TurnAngle(const b2Vec2& a, const b2Vec2& b, const b2Vec2& c) {
+  b2Vec2 in = b - a;
+  b2Vec2 out = c - b;
+  return atan2f(b2Cross(in, out), b2Dot(in, out));
+}
+
+void DecomposeThickPolyline(const Polyline& points, float half_width,
+                            float tolerance,
+                            std::vector<Polyline>* polygons) {
+  // Lines that turn further than this together are never merged, which
+  // keeps the outline of a merged run from overlapping itself.
+  const float kMaxTurn = b2_pi / 2;
+  int count = points.size();
+  Polyline outline;
+  Polyline hull;
+  Polyline candidate;
+  int start = 0;
+  while (start < count - 1) {
+    // A single line is always a box.
+    int end = start + 1;
+    ThickOutline(points, start, end, half_width, &outline);
+    ConvexHull(outline, &hull);
+    float length = b2Distance(points[start], points[end]);
+    float turn = 0;
+
+    while (end + 1 < count) {
+      float next_turn =
+          turn + TurnAngle(points[end - 1], points[end], points[end + 1]);
+      if (fabsf(next_turn) > kMaxTurn ||
+          (turn != 0 && (next_turn > 0) != (turn > 0)))
+        break;
+      float next_length = length + b2Distance(points[end], points[end + 1]);
+      ThickOutline(points, start, end + 1, half_width, &outline);
+      ConvexHull(outline, &candidate);
+      if ((int)candidate.size() > b2_maxPolygonVertices)
+        break;
+      float extra = PolygonArea(candidate) - fabsf(PolygonArea(outline));
+      if (extra > tolerance * next_length)
+        break;
+      hull.swap(candidate);
+      length = next_length;
+      turn = next_turn;
+      end++;
+    }
+
+    polygons->push_back(hull);
+    start = end;
+  }
+}
+
+// Returns true if p is inside or on the counter-clockwise triangle abc.
+static bool InTriangle(const b2Vec2& p, const b2Vec2& a, const b2Vec2& b,
+                       const b2Vec2& c) {
+  return b2Cross(b - a, p - a) >= 0 && b2Cross(c - b, p - b) >= 0 &&
+         b2Cross(a - c, p - c) >= 0;
+}
+
+// Returns true if the polygon of outline indices is strictly convex
+// at every vertex.
+static bool IsConvex(const Polyline& outline, const std::vector<int>& polygon) {
+  int count = polygon.size();
+  for (int i = 0; i < count; i++) {
+    const b2Vec2& a = outline[polygon[i]];
+    const b2Vec2& b = outline[polygon[(i + 1) % count]];
+    const b2Vec2& c = outline[polygon[(i + 2) % count]];
+    if (b2Cross(b - a, c - b) <= b2_epsilon)
+      return false;
+  }
+  return true;
+}
+
+// Merge polygon b into polygon a if they share an edge and the result
+// is convex and small enough.
+static bool MergePolygons(const Polyline& outline, std::vector<int>* a,
+                          const std::vector<int>& b) {
+  int count_a = a->size();
+  int count_b = b.size();
+  if (count_a + count_b - 2 > b2_maxPolygonVertices)
+    return false;
+  for (int i = 0; i < count_a; i++) {
+    int from = (*a)[i];
+    int to = (*a)[(i + 1) % count_a];
+    for (int j = 0; j < count_b; j++) {
+      if (b[j] != to || b[(j + 1) % count_b] != from)
+        continue;
+      // Walk a from the end of the shared edge round to its start, then
+      // b from after the shared edge round to before it.
+      std::vector<int> merged;
+      for (int k = 0; k < count_a; k++)
+        merged.push_back((*a)[(i + 1 + k) % count_a]);
+      for (int k = 2; k < count_b; k++)
+        merged.push_back(b[(j + k) % count_b]);
+      if (!IsConvex(outline, merged))
+        return false;
+      a->swap(merged);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if the segments a-b and c-d cross.
+static bool SegmentsCross(const b2Vec2& a, const b2Vec2& b, const b2Vec2& c,
+                          const b2Vec2& d) {
+  float c1 = b2Cross(b - a, c - a);
+  float c2 = b2Cross(b - a, d - a);
+  float c3 = b2Cross(d - c, a - c);
+  float c4 = b2Cross(d - c, b - c);
+  return ((c1 > 0 && c2 < 0) || (c1 < 0 && c2 > 0)) &&
+         ((c3 > 0 && c4 < 0) || (c3 < 0 && c4 > 0));
+}
+
+static bool IsSimple(const Polyline& polygon) {
+  int count = polygon.size();
+  for (int i = 0; i < count; i++) {
+    // Adjacent edges share a vertex, so start two edges further on.
+    for (int j = i + 2; j < count; j++) {
+      if (i == 0 && j == count - 1)
+        continue;
+      if (SegmentsCross(polygon[i], polygon[(i + 1) % count],
+                        polygon[j], polygon[(j + 1) % count]))
+        return false;
+    }
+  }
+  return true;
+}
+
+bool DecomposePolygon(const Polyline& outline,
+                      std::vector<Polyline>* polygons) {
+  if (outline.size() < 3 || !IsSimple(outline))
+    return false;
+  Polyline ccw(outline);
+  if (PolygonArea(ccw) < 0)
+    std::reverse(ccw.begin(), ccw.end());
+
+  // Ear clipping.
+  std::vector<int> remaining;
+  for (size_t i = 0; i < ccw.size(); i++)
+    remaining.push_back(i);
+  std::vector<std::vector<int> > pieces;
+  while (remaining.size() > 3) {
+    int count = remaining.size();
+    bool clipped = false;
+    for (int i = 0; i < count && !clipped; i++) {
+      int prev = remaining[(i + count - 1) % count];
+      int curr = remaining[i];
+      int next = remaining[(i + 1) % count];
+      const b2Vec2& a = ccw[prev];
+      const b2Vec2& b = ccw[curr];
+      const b2Vec2& c = ccw[next];
+      if (b2Cross(b - a, c - b) <= b2_epsilon)
+        continue;
+      bool ear = true;
+      for (int k = 0; k < count && ear; k++) {
+        int other = remaining[k];
+        if (other != prev && other != curr && other != next &&
+            InTriangle(ccw[other], a, b, c))
+          ear = false;
+      }
+      if (!ear)
+        continue;
+      std::vector<int> triangle;
+      triangle.push_back(prev);
+      triangle.push_back(curr);
+      triangle.push_back(next);
+      pieces.push_back(triangle);
+      remaining.erase(remaining.begin() + i);
+      clipped = true;
+    }
+    if (!clipped)
+      return false;
+  }
+  if (IsConvex(ccw, remaining))
+    pieces.push_back(remaining);
+
+  // Merge the triangles along shared edges while they stay convex.
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < pieces.size() && !merged; i++) {
+      for (size_t j = i + 1; j < pieces.size() && !merged; j++) {
+        if (MergePolygons(ccw, &pieces[i], pieces[j])) {
+          pieces.erase(pieces.begin() + j);
+          merged = true;
+        }
+      }
+    }
+  }
+
+  for (size_t i = 0; i < pieces.size(); i++) {
+    Polyline polygon;
+    for (size_t j = 0; j < pieces[i].size(); j++)
+      polygon.push_back(ccw[pieces[i][j]]);
+    polygons->push_back(polygon);
+  }
+  return true;
+}
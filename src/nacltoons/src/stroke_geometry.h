@@ -0,0 +1,45 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef STROKE_GEOMETRY_H_
+#define STROKE_GEOMETRY_H_
+
+#include <vector>
+
+#include "Box2D/Box2D.h"
+
+typedef std::vector<b2Vec2> Polyline;
+
+// Simplify a polyline with the Ramer-Douglas-Peucker algorithm.  The
+// points that are kept are written to 'result', and no point that is
+// dropped is further than 'tolerance' from the simplified line.  The
+// first and last points are always kept.
+void SimplifyPolyline(const Polyline& points, float tolerance,
+                      Polyline* result);
+
+// Signed area of a polygon, positive if it is counter-clockwise.
+float PolygonArea(const Polyline& polygon);
+
+// Compute the convex hull of a set of points.  The hull is written
+// counter-clockwise, without collinear points.
+void ConvexHull(const Polyline& points, Polyline* hull);
+
+// Cover a polyline of the given half width with convex polygons of at
+// most b2_maxPolygonVertices vertices, which are appended to
+// 'polygons'.  Consecutive lines share a polygon as long as its hull
+// adds no more than 'tolerance' times the length of the lines in area
+// over that of the lines themselves.  The ends of the polyline are
+// left square.
+void DecomposeThickPolyline(const Polyline& points, float half_width,
+                            float tolerance,
+                            std::vector<Polyline>* polygons);
+
+// Split a simple polygon into convex polygons of at most
+// b2_maxPolygonVertices vertices, which are appended to 'polygons'.
+// The polygon is triangulated by ear clipping and the triangles are
+// then merged.  Returns false, and adds nothing, if no triangulation
+// was found, for example because the polygon intersects itself.
+bool DecomposePolygon(const Polyline& outline,
+                      std::vector<Polyline>* polygons);
+
+#endif  // STROKE_GEOMETRY_H_
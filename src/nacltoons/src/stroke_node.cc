@@ -0,0 +1,199 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "stroke_node.h"
+#include "stroke_batch_node.h"
+
+#include <algorithm>
+#include <math.h>
+
+// Points closer than this (in points) to the end of a polyline don't
+// extend it.
+#define MIN_POINT_DISTANCE 0.01f
+
+// Limit on how far the corner of a sharp joint is pushed out, as a
+// multiple of the half width.
+#define MAX_MITER_SCALE 2.0f
+
+static CCPoint Direction(const CCPoint& from, const CCPoint& to) {
+  float dx = to.x - from.x;
+  float dy = to.y - from.y;
+  float length = sqrtf(dx * dx + dy * dy);
+  return CCPoint(dx / length, dy / length);
+}
+
+StrokeNode::StrokeNode()
+    : batch_(NULL),
+      half_width_(0),
+      vertices_dirty_(false),
+      version_(0) {
+}
+
+StrokeNode::~StrokeNode() {
+  CC_SAFE_RELEASE(batch_);
+}
+
+StrokeNode* StrokeNode::create(StrokeBatchNode* batch, float half_width) {
+  StrokeNode* node = new StrokeNode();
+  if (node && node->initWithBatch(batch, half_width)) {
+    node->autorelease();
+    return node;
+  }
+  delete node;
+  return NULL;
+}
+
+bool StrokeNode::initWithBatch(StrokeBatchNode* batch, float half_width) {
+  if (!CCNode::init() || !batch)
+    return false;
+  batch_ = batch;
+  batch_->retain();
+  half_width_ = half_width;
+  return true;
+}
+
+void StrokeNode::onEnter() {
+  CCNode::onEnter();
+  batch_->AddStroke(this);
+}
+
+void StrokeNode::onExit() {
+  batch_->RemoveStroke(this);
+  CCNode::onExit();
+}
+
+void StrokeNode::MoveTo(float x, float y, const ccColor3B& color) {
+  StrokePoint point = { CCPoint(x, y), color };
+  polylines_.push_back(points_.size());
+  points_.push_back(point);
+  vertices_dirty_ = true;
+  version_++;
+}
+
+void StrokeNode::LineTo(float x, float y, const ccColor3B& color) {
+  if (polylines_.empty()) {
+    MoveTo(x, y, color);
+    return;
+  }
+  const CCPoint& last = points_.back().pos;
+  if (fabsf(x - last.x) < MIN_POINT_DISTANCE &&
+      fabsf(y - last.y) < MIN_POINT_DISTANCE)
+    return;
+  StrokePoint point = { CCPoint(x, y), color };
+  points_.push_back(point);
+  vertices_dirty_ = true;
+  version_++;
+}
+
+void StrokeNode::AddLine(float x1, float y1, float x2, float y2,
+                         const ccColor3B& color) {
+  bool continues = false;
+  if (!polylines_.empty()) {
+    const CCPoint& last = points_.back().pos;
+    continues = fabsf(x1 - last.x) < MIN_POINT_DISTANCE &&
+                fabsf(y1 - last.y) < MIN_POINT_DISTANCE;
+  }
+  if (!continues)
+    MoveTo(x1, y1, color);
+  LineTo(x2, y2, color);
+}
+
+void StrokeNode::Clear() {
+  points_.clear();
+  polylines_.clear();
+  vertices_.clear();
+  vertices_dirty_ = false;
+  version_++;
+}
+
+const std::vector<ccV2F_C4B_T2F>& StrokeNode::GetVertices() {
+  if (vertices_dirty_) {
+    vertices_.clear();
+    for (size_t i = 0; i < polylines_.size(); i++) {
+      int end = i + 1 < polylines_.size() ? polylines_[i + 1] : points_.size();
+      BuildPolyline(polylines_[i], end);
+    }
+    vertices_dirty_ = false;
+  }
+  return vertices_;
+}
+
+void StrokeNode::AddVertexPair(const CCPoint& pos, const CCPoint& offset,
+                               const ccColor3B& color, float u) {
+  CCTexture2D* texture = batch_->getTexture();
+  float max_s = texture->getMaxS();
+  float max_t = texture->getMaxT();
+  ccColor4B color4 = ccc4(color.r, color.g, color.b, 255);
+
+  ccV2F_C4B_T2F vertex;
+  vertex.colors = color4;
+  vertex.vertices = vertex2(pos.x + offset.x, pos.y + offset.y);
+  vertex.texCoords = tex2(u * max_s, 0);
+  vertices_.push_back(vertex);
+  vertex.vertices = vertex2(pos.x - offset.x, pos.y - offset.y);
+  vertex.texCoords = tex2(u * max_s, max_t);
+  vertices_.push_back(vertex);
+}
+
+void StrokeNode::BuildPolyline(int start, int end) {
+  // Polylines are joined into one strip with degenerate triangles, by
+  // repeating the last vertex of one and the first of the next.
+  bool join = !vertices_.empty();
+  if (join)
+    vertices_.push_back(vertices_.back());
+  size_t first_vertex = vertices_.size();
+
+  float w = half_width_;
+  const StrokePoint& first = points_[start];
+  const StrokePoint& last = points_[end - 1];
+  CCPoint start_dir(1, 0);
+  CCPoint end_dir(1, 0);
+  if (end - start > 1) {
+    start_dir = Direction(first.pos, points_[start + 1].pos);
+    end_dir = Direction(points_[end - 2].pos, last.pos);
+  }
+
+  // The ends are capped with the two halves of the brush texture, so a
+  // single point is drawn like a brush sprite.
+  CCPoint cap(start_dir.x * w, start_dir.y * w);
+  AddVertexPair(CCPoint(first.pos.x - cap.x, first.pos.y - cap.y),
+                CCPoint(-cap.y, cap.x), first.color, 0);
+
+  // In between, the middle column of the texture is stretched along
+  // the lines, with the sides pushed out at the joints so that the
+  // stroke keeps its width.
+  if (end - start > 1) {
+    for (int i = start; i < end; i++) {
+      CCPoint normal;
+      if (i == start) {
+        normal = CCPoint(-start_dir.y, start_dir.x);
+      } else if (i == end - 1) {
+        normal = CCPoint(-end_dir.y, end_dir.x);
+      } else {
+        CCPoint in = Direction(points_[i - 1].pos, points_[i].pos);
+        CCPoint out = Direction(points_[i].pos, points_[i + 1].pos);
+        CCPoint sum(-in.y - out.y, in.x + out.x);
+        float length = sqrtf(sum.x * sum.x + sum.y * sum.y);
+        if (length < 0.001f) {
+          // The line doubles back on itself.
+          normal = CCPoint(-in.y, in.x);
+        } else {
+          float dot = (sum.x * -in.y + sum.y * in.x) / length;
+          float scale = 1.0f / (length * std::max(dot, 1.0f / MAX_MITER_SCALE));
+          normal = CCPoint(sum.x * scale, sum.y * scale);
+        }
+      }
+      AddVertexPair(points_[i].pos, CCPoint(normal.x * w, normal.y * w),
+                    points_[i].color, 0.5f);
+    }
+  }
+
+  cap = CCPoint(end_dir.x * w, end_dir.y * w);
+  AddVertexPair(CCPoint(last.pos.x + cap.x, last.pos.y + cap.y),
+                CCPoint(-cap.y, cap.x), last.color, 1);
+
+  if (join) {
+    ccV2F_C4B_T2F first_copy = vertices_[first_vertex];
+    vertices_.insert(vertices_.begin() + first_vertex, first_copy);
+  }
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef STROKE_NODE_H_
+#define STROKE_NODE_H_
+
+#include <vector>
+
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+class StrokeBatchNode;
+
+/**
+ * Node for a stroke drawn with the brush.  The stroke is kept as a set
+ * of polylines in the node's coordinate space and is turned into a
+ * single textured triangle strip, with the brush texture stretched
+ * along each line and stamped at the ends.  The node draws nothing
+ * itself: while it is running it is registered with a StrokeBatchNode,
+ * which draws the strips of all its strokes together.  Unlike a sprite
+ * per brush step, a stroke is a single node however long it gets.
+ */
+class StrokeNode : public CCNode {
+ public:
+  StrokeNode();
+  ~StrokeNode();
+
+  // Create a stroke that is drawn by the given batch.  'half_width' is
+  // half the width of the stroke, in points.
+  static StrokeNode* create(StrokeBatchNode* batch, float half_width);
+  bool initWithBatch(StrokeBatchNode* batch, float half_width);
+
+  virtual void onEnter();
+  virtual void onExit();
+
+  // Start a new polyline at the given point.
+  void MoveTo(float x, float y, const ccColor3B& color);
+
+  // Extend the current polyline to the given point, or start one if
+  // there is none.  Points that are on top of the end of the polyline
+  // are ignored.
+  void LineTo(float x, float y, const ccColor3B& color);
+
+  // Add a line to the stroke.  If the line starts where the current
+  // polyline ends it extends the polyline, so that the joint is smooth.
+  void AddLine(float x1, float y1, float x2, float y2,
+               const ccColor3B& color);
+
+  void Clear();
+  int GetPointCount() const { return points_.size(); }
+  float GetHalfWidth() const { return half_width_; }
+
+  // Vertices of the stroke's triangle strip, in node space.
+  const std::vector<ccV2F_C4B_T2F>& GetVertices();
+
+  // Incremented each time the geometry of the stroke changes.
+  unsigned GetVersion() const { return version_; }
+
+ private:
+  struct StrokePoint {
+    CCPoint pos;
+    ccColor3B color;
+  };
+
+  // Append the strip for the polyline points_[start, end).
+  void BuildPolyline(int start, int end);
+  void AddVertexPair(const CCPoint& pos, const CCPoint& offset,
+                     const ccColor3B& color, float u);
+
+  StrokeBatchNode* batch_;
+  float half_width_;
+  std::vector<StrokePoint> points_;
+  // Index into points_ of the first point of each polyline.
+  std::vector<int> polylines_;
+  std::vector<ccV2F_C4B_T2F> vertices_;
+  bool vertices_dirty_;
+  unsigned version_;
+};
+
+#endif  // STROKE_NODE_H_
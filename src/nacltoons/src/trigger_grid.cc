@@ -0,0 +1,121 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "trigger_grid.h"
+
+#include <assert.h>
+#include <math.h>
+
+TriggerGrid::TriggerGrid(float cell_size)
+    : cell_size_(cell_size),
+      query_stamp_(0) {
+  assert(cell_size > 0);
+}
+
+int TriggerGrid::CellCoord(float value) const {
+  return (int)floorf(value / cell_size_);
+}
+
+int TriggerGrid::Bucket(int x, int y) const {
+  // Hash the cell coordinates so that the grid is unbounded.
+  unsigned hash = (unsigned)x * 73856093u ^ (unsigned)y * 19349663u;
+  return hash & (kBucketCount - 1);
+}
+
+void TriggerGrid::InsertTrigger(int index) {
+  const Trigger& trigger = triggers_[index];
+  int x0 = CellCoord(trigger.center.x - trigger.radius);
+  int x1 = CellCoord(trigger.center.x + trigger.radius);
+  int y0 = CellCoord(trigger.center.y - trigger.radius);
+  int y1 = CellCoord(trigger.center.y + trigger.radius);
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      std::vector<int>& bucket = buckets_[Bucket(x, y)];
+      // Neighbouring cells can share a bucket.
+      if (bucket.empty() || bucket.back() != index)
+        bucket.push_back(index);
+    }
+  }
+}
+
+void TriggerGrid::RebuildBuckets() {
+  for (int i = 0; i < kBucketCount; i++)
+    buckets_[i].clear();
+  for (size_t i = 0; i < triggers_.size(); i++)
+    InsertTrigger(i);
+}
+
+int TriggerGrid::FindTrigger(int tag) const {
+  for (size_t i = 0; i < triggers_.size(); i++) {
+    if (triggers_[i].tag == tag)
+      return i;
+  }
+  return -1;
+}
+
+void TriggerGrid::Add(int tag, const b2Vec2& center, float radius) {
+  Trigger trigger = { tag, center, radius, query_stamp_ };
+  int index = FindTrigger(tag);
+  if (index >= 0) {
+    triggers_[index] = trigger;
+    RebuildBuckets();
+    return;
+  }
+  triggers_.push_back(trigger);
+  InsertTrigger(triggers_.size() - 1);
+}
+
+void TriggerGrid::Remove(int tag) {
+  int index = FindTrigger(tag);
+  if (index < 0)
+    return;
+  triggers_.erase(triggers_.begin() + index);
+  RebuildBuckets();
+}
+
+void TriggerGrid::Clear() {
+  triggers_.clear();
+  RebuildBuckets();
+}
+
+// Returns true if the circle overlaps the box.
+static bool Overlaps(const b2Vec2& center, float radius, const b2AABB& aabb) {
+  b2Vec2 closest = b2Clamp(center, aabb.lowerBound, aabb.upperBound);
+  return (center - closest).LengthSquared() <= radius * radius;
+}
+
+void TriggerGrid::Query(const b2AABB& aabb, std::vector<int>* tags) {
+  if (triggers_.empty())
+    return;
+
+  int x0 = CellCoord(aabb.lowerBound.x);
+  int x1 = CellCoord(aabb.upperBound.x);
+  int y0 = CellCoord(aabb.lowerBound.y);
+  int y1 = CellCoord(aabb.upperBound.y);
+
+  // A box covering more cells than there are buckets would visit every
+  // bucket at least once, so just test every trigger.
+  if ((float)(x1 - x0 + 1) * (y1 - y0 + 1) > kBucketCount) {
+    for (size_t i = 0; i < triggers_.size(); i++) {
+      const Trigger& trigger = triggers_[i];
+      if (Overlaps(trigger.center, trigger.radius, aabb))
+        tags->push_back(trigger.tag);
+    }
+    return;
+  }
+
+  query_stamp_++;
+  for (int y = y0; y <= y1; y++) {
+    for (int x = x0; x <= x1; x++) {
+      const std::vector<int>& bucket = buckets_[Bucket(x, y)];
+      for (size_t i = 0; i < bucket.size(); i++) {
+        Trigger& trigger = triggers_[bucket[i]];
+        if (trigger.stamp == query_stamp_)
+          continue;
+        trigger.stamp = query_stamp_;
+        if (Overlaps(trigger.center, trigger.radius, aabb))
+          tags->push_back(trigger.tag);
+      }
+    }
+  }
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef TRIGGER_GRID_H_
+#define TRIGGER_GRID_H_
+
+#include <vector>
+
+#include "Box2D/Box2D.h"
+
+/**
+ * Spatial hash of circular trigger volumes.  Triggers only need to
+ * detect when something passes through them, so they are kept out of
+ * the box2d world where, as sensors, they would add proxies and
+ * broad-phase pairs to every step.  The plane is divided into a uniform
+ * grid of square cells and each trigger is stored in the hash bucket of
+ * every cell it overlaps.
+ */
+class TriggerGrid {
+ public:
+  explicit TriggerGrid(float cell_size);
+
+  // Add a trigger with the given tag.  Any existing trigger with the
+  // same tag is replaced.  Replacing or removing a trigger rebuilds the
+  // grid, which is fine for the handful of triggers in a level.
+  void Add(int tag, const b2Vec2& center, float radius);
+  void Remove(int tag);
+  void Clear();
+  bool IsEmpty() const { return triggers_.empty(); }
+
+  // Append to 'tags' the tag of each trigger that overlaps the given
+  // box.  Each tag is added at most once.
+  void Query(const b2AABB& aabb, std::vector<int>* tags);
+
+ private:
+  enum {
+    // Number of hash buckets.  Must be a power of two.
+    kBucketCount = 256
+  };
+
+  struct Trigger {
+    int tag;
+    b2Vec2 center;
+    float radius;
+    // Value of query_stamp_ for the last query that reported this
+    // trigger, to filter out duplicates.
+    unsigned stamp;
+  };
+
+  int CellCoord(float value) const;
+  int Bucket(int x, int y) const;
+  void InsertTrigger(int index);
+  // Rebuild all buckets, after the indices of triggers have changed.
+  void RebuildBuckets();
+  int FindTrigger(int tag) const;
+
+  float cell_size_;
+  std::vector<Trigger> triggers_;
+  // Indices into triggers_.
+  std::vector<int> buckets_[kBucketCount];
+  unsigned query_stamp_;
+};
+
+#endif  // TRIGGER_GRID_H_
@@ -0,0 +1,84 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "worker_thread.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+WorkerThread::WorkerThread()
+    : task_(NULL),
+      started_(false),
+      quit_(false) {
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&cond_, NULL);
+}
+
+WorkerThread::~WorkerThread() {
+  if (started_) {
+    pthread_mutex_lock(&mutex_);
+    while (task_)
+      pthread_cond_wait(&cond_, &mutex_);
+    quit_ = true;
+    pthread_cond_broadcast(&cond_);
+    pthread_mutex_unlock(&mutex_);
+    pthread_join(thread_, NULL);
+  }
+  pthread_cond_destroy(&cond_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool WorkerThread::Start() {
+  assert(!started_);
+  if (pthread_create(&thread_, NULL, ThreadMain, this) != 0)
+    return false;
+  started_ = true;
+  return true;
+}
+
+void WorkerThread::Post(WorkerTask* task) {
+  assert(started_);
+  pthread_mutex_lock(&mutex_);
+  assert(!task_);
+  task_ = task;
+  pthread_cond_broadcast(&cond_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void WorkerThread::Wait() {
+  pthread_mutex_lock(&mutex_);
+  while (task_)
+    pthread_cond_wait(&cond_, &mutex_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+bool WorkerThread::IsBusy() {
+  pthread_mutex_lock(&mutex_);
+  bool busy = task_ != NULL;
+  pthread_mutex_unlock(&mutex_);
+  return busy;
+}
+
+void* WorkerThread::ThreadMain(void* arg) {
+  static_cast<WorkerThread*>(arg)->Loop();
+  return NULL;
+}
+
+void WorkerThread::Loop() {
+  pthread_mutex_lock(&mutex_);
+  while (true) {
+    while (!task_ && !quit_)
+      pthread_cond_wait(&cond_, &mutex_);
+    if (quit_)
+      break;
+
+    WorkerTask* task = task_;
+    pthread_mutex_unlock(&mutex_);
+    task->Run();
+    pthread_mutex_lock(&mutex_);
+
+    task_ = NULL;
+    pthread_cond_broadcast(&cond_);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef WORKER_THREAD_H_
+#define WORKER_THREAD_H_
+
+#include <pthread.h>
+
+/**
+ * Unit of work that can be run on a WorkerThread.
+ */
+class WorkerTask {
+ public:
+  virtual ~WorkerTask() {}
+  virtual void Run() = 0;
+};
+
+/**
+ * Background thread which runs one WorkerTask at a time.  Tasks are
+ * posted from the main thread, which later waits for them to complete.
+ */
+class WorkerThread {
+ public:
+  WorkerThread();
+
+  // Waits for any running task and then stops the thread.
+  ~WorkerThread();
+
+  bool Start();
+
+  // Run the given task on the worker thread.  The previous task must
+  // have completed (see Wait).
+  void Post(WorkerTask* task);
+
+  // Block until the currently posted task, if any, has completed.
+  void Wait();
+
+  bool IsBusy();
+
+ private:
+  static void* ThreadMain(void* arg);
+  void Loop();
+
+  pthread_t thread_;
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+  WorkerTask* task_;
+  bool started_;
+  bool quit_;
+};
+
+#endif  // WORKER_THREAD_H_
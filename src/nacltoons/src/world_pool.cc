@@ -0,0 +1,87 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "world_pool.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#define DEFAULT_GRAVITY b2Vec2(0.0f, -9.8f)
+
+WorldPool::WorldPool()
+    : worlds_created_(0),
+      worlds_reused_(0),
+      max_bodies_(0),
+      max_joints_(0),
+      max_contacts_(0),
+      max_proxies_(0),
+      max_tree_height_(0) {
+  free_worlds_.reserve(kMaxFreeWorlds);
+}
+
+WorldPool::~WorldPool() {
+  for (size_t i = 0; i < free_worlds_.size(); i++)
+    delete free_worlds_[i];
+}
+
+b2World* WorldPool::Acquire() {
+  if (free_worlds_.empty()) {
+    worlds_created_++;
+    return new b2World(DEFAULT_GRAVITY);
+  }
+
+  b2World* world = free_worlds_.back();
+  free_worlds_.pop_back();
+  worlds_reused_++;
+  return world;
+}
+
+void WorldPool::Release(b2World* world) {
+  if (!world)
+    return;
+  assert(!world->IsLocked());
+  RecordUsage(world);
+
+  if (free_worlds_.size() >= kMaxFreeWorlds) {
+    delete world;
+    return;
+  }
+
+  ResetWorld(world);
+  free_worlds_.push_back(world);
+}
+
+void WorldPool::RecordUsage(b2World* world) {
+  max_bodies_ = std::max(max_bodies_, (int)world->GetBodyCount());
+  max_joints_ = std::max(max_joints_, (int)world->GetJointCount());
+  max_contacts_ = std::max(max_contacts_, (int)world->GetContactCount());
+  max_proxies_ = std::max(max_proxies_, (int)world->GetProxyCount());
+  max_tree_height_ = std::max(max_tree_height_, (int)world->GetTreeHeight());
+}
+
+void WorldPool::ResetWorld(b2World* world) {
+  // The listeners belong to the level that is going away.  Clear them
+  // first so that destroying the bodies doesn't call into it.
+  world->SetContactListener(NULL);
+  world->SetDestructionListener(NULL);
+  world->SetDebugDraw(NULL);
+
+  // Destroying the bodies also destroys their joints, fixtures and
+  // contacts.  The memory goes back to the world's block allocator and
+  // the broad-phase keeps its tree capacity.
+  b2Body* body = world->GetBodyList();
+  while (body) {
+    b2Body* next = body->GetNext();
+    world->DestroyBody(body);
+    body = next;
+  }
+  assert(world->GetJointCount() == 0);
+  assert(world->GetContactCount() == 0);
+
+  world->SetGravity(DEFAULT_GRAVITY);
+  world->SetAllowSleeping(true);
+  world->SetWarmStarting(true);
+  world->SetContinuousPhysics(true);
+  world->SetSubStepping(false);
+  world->SetAutoClearForces(true);
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef WORLD_POOL_H_
+#define WORLD_POOL_H_
+
+#include <vector>
+
+#include "Box2D/Box2D.h"
+
+/**
+ * Pool of box2d worlds that are reused across level restarts and level
+ * changes.  Deleting a world frees the pages of its block allocator and
+ * the node storage of its broad-phase tree, which a new world then has
+ * to allocate again as the level is built.  Released worlds are instead
+ * emptied and kept, so that once the pool is warm loading a level does
+ * no large heap allocations.
+ *
+ * The pool also keeps high-water marks of the number of objects that
+ * the worlds have held, which can be used to tune the level data.
+ */
+class WorldPool {
+ public:
+  WorldPool();
+  ~WorldPool();
+
+  // Returns an empty world with default settings.
+  b2World* Acquire();
+
+  // Return a world to the pool.  Any bodies and joints still in the
+  // world are destroyed.  The world must not be stepping.
+  void Release(b2World* world);
+
+  // Update the high-water marks from the current contents of a world.
+  void RecordUsage(b2World* world);
+
+  int GetWorldsCreated() const { return worlds_created_; }
+  int GetWorldsReused() const { return worlds_reused_; }
+  int GetMaxBodies() const { return max_bodies_; }
+  int GetMaxJoints() const { return max_joints_; }
+  int GetMaxContacts() const { return max_contacts_; }
+  int GetMaxProxies() const { return max_proxies_; }
+  int GetMaxTreeHeight() const { return max_tree_height_; }
+
+ private:
+  enum {
+    // Number of idle worlds kept.  One is enough for restarts; the
+    // second covers the transition between two levels.
+    kMaxFreeWorlds = 2
+  };
+
+  void ResetWorld(b2World* world);
+
+  std::vector<b2World*> free_worlds_;
+  int worlds_created_;
+  int worlds_reused_;
+  int max_bodies_;
+  int max_joints_;
+  int max_contacts_;
+  int max_proxies_;
+  int max_tree_height_;
+};
+
+#endif  // WORLD_POOL_H_
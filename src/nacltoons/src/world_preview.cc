@@ -0,0 +1,268 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "world_preview.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <map>
+
+#include "cocos2d.h"
+
+WorldPreview::WorldPreview()
+    : thread_started_(false),
+      cancelled_(false),
+      paused_(false),
+      stepping_(false),
+      world_(NULL),
+      steps_(0),
+      sample_interval_(1),
+      timestep_(0),
+      velocity_iterations_(0),
+      position_iterations_(0),
+      sample_count_(0) {
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&cond_, NULL);
+}
+
+WorldPreview::~WorldPreview() {
+  Cancel();
+  thread_.Wait();
+  delete world_;
+  pthread_cond_destroy(&cond_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool WorldPreview::Start(b2World* world, const std::vector<int>& tags,
+                         int steps, int sample_interval, float timestep,
+                         int velocity_iterations, int position_iterations) {
+  assert(!world->IsLocked());
+  if (!thread_started_) {
+    if (!thread_.Start()) {
+      cocos2d::CCLog("failed to start preview thread");
+      return false;
+    }
+    thread_started_ = true;
+  }
+
+  // Stepping is checked for cancellation between steps, so this only
+  // waits for at most one step of the previous simulation.
+  Cancel();
+  thread_.Wait();
+  delete world_;
+
+  pthread_mutex_lock(&mutex_);
+  cancelled_ = false;
+  pthread_mutex_unlock(&mutex_);
+
+  world_ = CloneWorld(world, tags);
+  steps_ = steps;
+  sample_interval_ = sample_interval > 0 ? sample_interval : 1;
+  timestep_ = timestep;
+  velocity_iterations_ = velocity_iterations;
+  position_iterations_ = position_iterations;
+  samples_.clear();
+  samples_.reserve((steps / sample_interval_ + 1) * tags.size() * 2);
+  sample_count_ = 0;
+
+  thread_.Post(this);
+  return true;
+}
+
+void WorldPreview::Cancel() {
+  pthread_mutex_lock(&mutex_);
+  cancelled_ = true;
+  // Wake the worker if it is paused so that it can stop.
+  pthread_cond_broadcast(&cond_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void WorldPreview::Pause() {
+  pthread_mutex_lock(&mutex_);
+  paused_ = true;
+  while (stepping_)
+    pthread_cond_wait(&cond_, &mutex_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void WorldPreview::Resume() {
+  pthread_mutex_lock(&mutex_);
+  paused_ = false;
+  pthread_cond_broadcast(&cond_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+bool WorldPreview::BeginStep() {
+  pthread_mutex_lock(&mutex_);
+  while (paused_ && !cancelled_)
+    pthread_cond_wait(&cond_, &mutex_);
+  bool run = !cancelled_;
+  stepping_ = run;
+  pthread_mutex_unlock(&mutex_);
+  return run;
+}
+
+void WorldPreview::EndStep() {
+  pthread_mutex_lock(&mutex_);
+  stepping_ = false;
+  pthread_cond_broadcast(&cond_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+bool WorldPreview::IsCancelled() {
+  pthread_mutex_lock(&mutex_);
+  bool cancelled = cancelled_;
+  pthread_mutex_unlock(&mutex_);
+  return cancelled;
+}
+
+bool WorldPreview::PollFinished() {
+  if (!world_ || thread_.IsBusy())
+    return false;
+  delete world_;
+  world_ = NULL;
+  tracked_bodies_.clear();
+  return !IsCancelled();
+}
+
+void WorldPreview::Run() {
+  RecordSample();
+  for (int i = 1; i <= steps_; i++) {
+    if (!BeginStep())
+      return;
+    world_->Step(timestep_, velocity_iterations_, position_iterations_);
+    EndStep();
+    if (i % sample_interval_ == 0)
+      RecordSample();
+  }
+}
+
+void WorldPreview::RecordSample() {
+  for (size_t i = 0; i < tracked_bodies_.size(); i++) {
+    b2Body* body = tracked_bodies_[i];
+    if (body) {
+      const b2Vec2& position = body->GetPosition();
+      samples_.push_back(position.x);
+      samples_.push_back(position.y);
+    } else {
+      samples_.push_back(0);
+      samples_.push_back(0);
+    }
+  }
+  sample_count_++;
+}
+
+b2World* WorldPreview::CloneWorld(b2World* world,
+                                  const std::vector<int>& tags) {
+  b2World* clone = new b2World(world->GetGravity());
+  clone->SetAllowSleeping(world->GetAllowSleeping());
+  clone->SetWarmStarting(world->GetWarmStarting());
+  clone->SetContinuousPhysics(world->GetContinuousPhysics());
+  clone->SetSubStepping(world->GetSubStepping());
+
+  tracked_bodies_.assign(tags.size(), NULL);
+  std::map<b2Body*, b2Body*> body_map;
+
+  for (b2Body* body = world->GetBodyList(); body; body = body->GetNext()) {
+    b2BodyDef body_def;
+    body_def.type = body->GetType();
+    body_def.position = body->GetPosition();
+    body_def.angle = body->GetAngle();
+    body_def.linearVelocity = body->GetLinearVelocity();
+    body_def.angularVelocity = body->GetAngularVelocity();
+    body_def.linearDamping = body->GetLinearDamping();
+    body_def.angularDamping = body->GetAngularDamping();
+    body_def.allowSleep = body->IsSleepingAllowed();
+    body_def.awake = body->IsAwake();
+    body_def.fixedRotation = body->IsFixedRotation();
+    body_def.bullet = body->IsBullet();
+    body_def.active = body->IsActive();
+    body_def.gravityScale = body->GetGravityScale();
+    body_def.userData = body->GetUserData();
+    b2Body* copy = clone->CreateBody(&body_def);
+    body_map[body] = copy;
+
+    // The shapes are cloned by CreateFixture so they can be shared with
+    // the live world.
+    for (b2Fixture* fixture = body->GetFixtureList(); fixture;
+         fixture = fixture->GetNext()) {
+      b2FixtureDef fixture_def;
+      fixture_def.shape = fixture->GetShape();
+      fixture_def.userData = fixture->GetUserData();
+      fixture_def.friction = fixture->GetFriction();
+      fixture_def.restitution = fixture->GetRestitution();
+      fixture_def.density = fixture->GetDensity();
+      fixture_def.isSensor = fixture->IsSensor();
+      fixture_def.filter = fixture->GetFilterData();
+      copy->CreateFixture(&fixture_def);
+    }
+
+    int tag = (intptr_t)body->GetUserData();
+    if (!tag)
+      continue;
+    for (size_t i = 0; i < tags.size(); i++) {
+      if (tags[i] == tag)
+        tracked_bodies_[i] = copy;
+    }
+  }
+
+  for (b2Joint* joint = world->GetJointList(); joint;
+       joint = joint->GetNext()) {
+    b2Body* body_a = body_map[joint->GetBodyA()];
+    b2Body* body_b = body_map[joint->GetBodyB()];
+    switch (joint->GetType()) {
+      case e_revoluteJoint: {
+        b2RevoluteJoint* revolute = static_cast<b2RevoluteJoint*>(joint);
+        b2RevoluteJointDef def;
+        def.localAnchorA = revolute->GetLocalAnchorA();
+        def.localAnchorB = revolute->GetLocalAnchorB();
+        def.referenceAngle = revolute->GetReferenceAngle();
+        def.enableLimit = revolute->IsLimitEnabled();
+        def.lowerAngle = revolute->GetLowerLimit();
+        def.upperAngle = revolute->GetUpperLimit();
+        def.enableMotor = revolute->IsMotorEnabled();
+        def.motorSpeed = revolute->GetMotorSpeed();
+        def.maxMotorTorque = revolute->GetMaxMotorTorque();
+        def.bodyA = body_a;
+        def.bodyB = body_b;
+        def.collideConnected = joint->GetCollideConnected();
+        clone->CreateJoint(&def);
+        break;
+      }
+      case e_distanceJoint: {
+        b2DistanceJoint* distance = static_cast<b2DistanceJoint*>(joint);
+        b2DistanceJointDef def;
+        def.localAnchorA = distance->GetLocalAnchorA();
+        def.localAnchorB = distance->GetLocalAnchorB();
+        def.length = distance->GetLength();
+        def.frequencyHz = distance->GetFrequency();
+        def.dampingRatio = distance->GetDampingRatio();
+        def.bodyA = body_a;
+        def.bodyB = body_b;
+        def.collideConnected = joint->GetCollideConnected();
+        clone->CreateJoint(&def);
+        break;
+      }
+      case e_weldJoint: {
+        b2WeldJoint* weld = static_cast<b2WeldJoint*>(joint);
+        b2WeldJointDef def;
+        def.localAnchorA = weld->GetLocalAnchorA();
+        def.localAnchorB = weld->GetLocalAnchorB();
+        def.referenceAngle = weld->GetReferenceAngle();
+        def.frequencyHz = weld->GetFrequency();
+        def.dampingRatio = weld->GetDampingRatio();
+        def.bodyA = body_a;
+        def.bodyB = body_b;
+        def.collideConnected = joint->GetCollideConnected();
+        clone->CreateJoint(&def);
+        break;
+      }
+      default:
+        // The game only creates the joint types above.
+        cocos2d::CCLog("preview: ignoring joint of type %d", joint->GetType());
+        break;
+    }
+  }
+
+  return clone;
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef WORLD_PREVIEW_H_
+#define WORLD_PREVIEW_H_
+
+#include <pthread.h>
+#include <vector>
+
+#include "Box2D/Box2D.h"
+#include "worker_thread.h"
+
+/**
+ * Speculative simulation of a box2d world.  Start() copies the bodies,
+ * fixtures and joints of a world and then steps the copy on a worker
+ * thread, sampling the positions of a set of tagged bodies as it goes.
+ * The live world is not touched after Start() returns.
+ */
+class WorldPreview : public WorkerTask {
+ public:
+  WorldPreview();
+
+  // Cancels any running simulation and waits for it to stop.
+  ~WorldPreview();
+
+  // Start simulating a copy of 'world' for 'steps' steps of 'timestep'
+  // seconds, recording the positions of the bodies with the given tags
+  // every 'sample_interval' steps.  Any simulation already running is
+  // cancelled first.  Must be called while the world is not being
+  // stepped.
+  bool Start(b2World* world, const std::vector<int>& tags, int steps,
+             int sample_interval, float timestep, int velocity_iterations,
+             int position_iterations);
+
+  // Ask the running simulation to stop.  Does not block; the results of
+  // a cancelled simulation are discarded.
+  void Cancel();
+
+  // Hold the simulation between steps, waiting for any step in progress
+  // to finish, until Resume() is called.  Box2D keeps global statistics
+  // (b2_gjkCalls, b2_toiCalls, ...) and builds some static tables on
+  // first use, none of which is thread safe, so the copy must not be
+  // stepped while the live world is.
+  void Pause();
+  void Resume();
+
+  // Returns true once if a simulation has finished since the last call
+  // and was not cancelled, in which case its results can be read with
+  // GetSamples().
+  bool PollFinished();
+
+  // Sampled positions in box2d world units.  Each sample holds an
+  // (x, y) pair for each of the tags passed to Start(), in order.  The
+  // position of a tag with no body is reported as (0, 0).
+  const std::vector<float>& GetSamples() const { return samples_; }
+  int GetSampleCount() const { return sample_count_; }
+
+  // WorkerTask implementation, called on the worker thread.
+  void Run();
+
+ private:
+  // Create a copy of 'world' and record the copies of the bodies with
+  // the given tags in 'tracked_bodies_'.
+  b2World* CloneWorld(b2World* world, const std::vector<int>& tags);
+  void RecordSample();
+  bool IsCancelled();
+  // Called by the worker around each step.  BeginStep waits while the
+  // simulation is paused and returns false if it was cancelled.
+  bool BeginStep();
+  void EndStep();
+
+  WorkerThread thread_;
+  bool thread_started_;
+
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+  bool cancelled_;
+  bool paused_;
+  bool stepping_;
+
+  // The copied world, which belongs to the worker thread while it is
+  // running.  NULL when no simulation is pending.
+  b2World* world_;
+  std::vector<b2Body*> tracked_bodies_;
+  int steps_;
+  int sample_interval_;
+  float timestep_;
+  int velocity_iterations_;
+  int position_iterations_;
+
+  std::vector<float> samples_;
+  int sample_count_;
+};
+
+#endif  // WORLD_PREVIEW_H_
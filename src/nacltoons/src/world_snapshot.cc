@@ -0,0 +1,358 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#include "world_snapshot.h"
+
+#include <algorithm>
+
+#include "physics_body_node.h"
+
+WorldSnapshot::WorldSnapshot() : captured_(false), invalidated_(false) {
+}
+
+WorldSnapshot::~WorldSnapshot() {
+  Clear();
+}
+
+void WorldSnapshot::Clear() {
+  // Nodes are retained while in the snapshot so that their addresses
+  // can't be reused by new nodes.
+  for (size_t i = 0; i < nodes_.size(); i++)
+    nodes_[i].node->release();
+  nodes_.clear();
+  bodies_.clear();
+  fixtures_.clear();
+  joints_.clear();
+  captured_ = false;
+  invalidated_ = false;
+}
+
+void WorldSnapshot::Capture(b2World* world, CCNode* root) {
+  Clear();
+
+  for (b2Body* body = world->GetBodyList(); body; body = body->GetNext()) {
+    BodyState state;
+    state.body = body;
+    state.user_data = body->GetUserData();
+    state.type = body->GetType();
+    state.position = body->GetPosition();
+    state.angle = body->GetAngle();
+    state.linear_velocity = body->GetLinearVelocity();
+    state.angular_velocity = body->GetAngularVelocity();
+    state.awake = body->IsAwake();
+    state.active = body->IsActive();
+    state.first_fixture = fixtures_.size();
+    for (b2Fixture* fixture = body->GetFixtureList(); fixture;
+         fixture = fixture->GetNext()) {
+      FixtureState fixture_state;
+      fixture_state.fixture = fixture;
+      fixture_state.density = fixture->GetDensity();
+      fixture_state.friction = fixture->GetFriction();
+      fixture_state.restitution = fixture->GetRestitution();
+      fixture_state.sensor = fixture->IsSensor();
+      fixture_state.filter = fixture->GetFilterData();
+      fixtures_.push_back(fixture_state);
+    }
+    state.fixture_count = fixtures_.size() - state.first_fixture;
+    // The shared static body can have a lot of fixtures.
+    std::sort(fixtures_.begin() + state.first_fixture, fixtures_.end(),
+              CompareFixtures);
+    bodies_.push_back(state);
+  }
+  std::sort(bodies_.begin(), bodies_.end(), CompareBodies);
+
+  for (b2Joint* joint = world->GetJointList(); joint;
+       joint = joint->GetNext()) {
+    JointState state;
+    state.joint = joint;
+    state.type = joint->GetType();
+    state.body_a = joint->GetBodyA();
+    state.body_b = joint->GetBodyB();
+    if (state.type == e_revoluteJoint) {
+      b2RevoluteJoint* revolute = static_cast<b2RevoluteJoint*>(joint);
+      state.motor_enabled = revolute->IsMotorEnabled();
+      state.motor_speed = revolute->GetMotorSpeed();
+      state.max_motor_torque = revolute->GetMaxMotorTorque();
+      state.limit_enabled = revolute->IsLimitEnabled();
+      state.lower_limit = revolute->GetLowerLimit();
+      state.upper_limit = revolute->GetUpperLimit();
+    }
+    joints_.push_back(state);
+  }
+  std::sort(joints_.begin(), joints_.end(), CompareJoints);
+
+  // The root itself is not captured since it owns the snapshot and
+  // retaining it would create a reference cycle.
+  CCArray* children = root->getChildren();
+  if (children) {
+    for (unsigned int i = 0; i < children->count(); i++)
+      CaptureNode(static_cast<CCNode*>(children->objectAtIndex(i)));
+  }
+  std::sort(nodes_.begin(), nodes_.end(), CompareNodes);
+
+  world->SetDestructionListener(this);
+  captured_ = true;
+}
+
+void WorldSnapshot::CaptureNode(CCNode* node) {
+  NodeState state;
+  state.node = node;
+  state.parent = node->getParent();
+  state.position = node->getPosition();
+  state.rotation = node->getRotation();
+  state.scale_x = node->getScaleX();
+  state.scale_y = node->getScaleY();
+  state.visible = node->isVisible();
+  state.has_body = dynamic_cast<CCPhysicsNode*>(node) != NULL;
+  CCRGBAProtocol* rgba = dynamic_cast<CCRGBAProtocol*>(node);
+  state.has_rgba = rgba != NULL;
+  if (rgba) {
+    state.opacity = rgba->getOpacity();
+    state.color = rgba->getColor();
+  }
+  node->retain();
+  nodes_.push_back(state);
+
+  CCArray* children = node->getChildren();
+  if (!children)
+    return;
+  for (unsigned int i = 0; i < children->count(); i++)
+    CaptureNode(static_cast<CCNode*>(children->objectAtIndex(i)));
+}
+
+bool WorldSnapshot::CompareBodies(const BodyState& state1,
+                                  const BodyState& state2) {
+  return state1.body < state2.body;
+}
+
+bool WorldSnapshot::CompareFixtures(const FixtureState& state1,
+                                    const FixtureState& state2) {
+  return state1.fixture < state2.fixture;
+}
+
+bool WorldSnapshot::CompareJoints(const JointState& state1,
+                                  const JointState& state2) {
+  return state1.joint < state2.joint;
+}
+
+bool WorldSnapshot::CompareNodes(const NodeState& state1,
+                                 const NodeState& state2) {
+  return state1.node < state2.node;
+}
+
+const WorldSnapshot::BodyState* WorldSnapshot::FindBody(b2Body* body) const {
+  BodyState key;
+  key.body = body;
+  std::vector<BodyState>::const_iterator it =
+      std::lower_bound(bodies_.begin(), bodies_.end(), key, CompareBodies);
+  if (it == bodies_.end() || it->body != body)
+    return NULL;
+  return &*it;
+}
+
+const WorldSnapshot::JointState* WorldSnapshot::FindJoint(
+    b2Joint* joint) const {
+  JointState key;
+  key.joint = joint;
+  std::vector<JointState>::const_iterator it =
+      std::lower_bound(joints_.begin(), joints_.end(), key, CompareJoints);
+  if (it == joints_.end() || it->joint != joint)
+    return NULL;
+  return &*it;
+}
+
+bool WorldSnapshot::InSnapshot(CCNode* node) const {
+  NodeState key;
+  key.node = node;
+  return std::binary_search(nodes_.begin(), nodes_.end(), key, CompareNodes);
+}
+
+bool WorldSnapshot::HasFixture(const BodyState& state,
+                               b2Fixture* fixture) const {
+  FixtureState key;
+  key.fixture = fixture;
+  std::vector<FixtureState>::const_iterator first =
+      fixtures_.begin() + state.first_fixture;
+  return std::binary_search(first, first + state.fixture_count, key,
+                            CompareFixtures);
+}
+
+void WorldSnapshot::SayGoodbye(b2Joint* joint) {
+  // Called for the joints of a body that is being destroyed.
+  if (FindJoint(joint))
+    invalidated_ = true;
+}
+
+void WorldSnapshot::SayGoodbye(b2Fixture* fixture) {
+  // Called for the fixtures of a body that is being destroyed.  The
+  // body's memory may then be reused by a new body.
+  if (FindBody(fixture->GetBody()))
+    invalidated_ = true;
+}
+
+bool WorldSnapshot::CanRestore(b2World* world) const {
+  if (!captured_ || invalidated_)
+    return false;
+
+  // All the nodes must still be attached to the same parent.
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    const NodeState& state = nodes_[i];
+    if (state.node->getParent() != state.parent)
+      return false;
+  }
+
+  // Every captured body must still exist with all of its fixtures.
+  // Fixtures that were destroyed explicitly can't be brought back.  The
+  // user data is compared too, since a body without fixtures can be
+  // destroyed without the listener hearing about it.
+  size_t found = 0;
+  for (b2Body* body = world->GetBodyList(); body; body = body->GetNext()) {
+    const BodyState* state = FindBody(body);
+    if (!state)
+      continue;
+    if (body->GetUserData() != state->user_data)
+      return false;
+    int fixtures = 0;
+    for (b2Fixture* fixture = body->GetFixtureList(); fixture;
+         fixture = fixture->GetNext()) {
+      if (HasFixture(*state, fixture))
+        fixtures++;
+    }
+    if (fixtures != state->fixture_count)
+      return false;
+    found++;
+  }
+  if (found != bodies_.size())
+    return false;
+
+  // Joints destroyed explicitly don't reach the listener either, so
+  // check that each one still connects the same bodies.
+  found = 0;
+  for (b2Joint* joint = world->GetJointList(); joint;
+       joint = joint->GetNext()) {
+    const JointState* state = FindJoint(joint);
+    if (!state)
+      continue;
+    if (joint->GetType() != state->type ||
+        joint->GetBodyA() != state->body_a ||
+        joint->GetBodyB() != state->body_b)
+      return false;
+    found++;
+  }
+  return found == joints_.size();
+}
+
+void WorldSnapshot::RemoveNewNodes(CCNode* node) {
+  CCArray* children = node->getChildren();
+  if (!children)
+    return;
+
+  // Iterate backwards since children are removed as we go.
+  for (int i = children->count() - 1; i >= 0; i--) {
+    CCNode* child = static_cast<CCNode*>(children->objectAtIndex(i));
+    if (InSnapshot(child))
+      RemoveNewNodes(child);
+    else
+      node->removeChild(child, true);
+  }
+}
+
+void WorldSnapshot::RestoreFixtures(const BodyState& state) {
+  b2Body* body = state.body;
+  b2Fixture* fixture = body->GetFixtureList();
+  while (fixture) {
+    b2Fixture* next = fixture->GetNext();
+    if (!HasFixture(state, fixture))
+      body->DestroyFixture(fixture);
+    fixture = next;
+  }
+
+  for (int i = 0; i < state.fixture_count; i++) {
+    const FixtureState& fixture_state = fixtures_[state.first_fixture + i];
+    b2Fixture* fixture = fixture_state.fixture;
+    fixture->SetDensity(fixture_state.density);
+    fixture->SetFriction(fixture_state.friction);
+    fixture->SetRestitution(fixture_state.restitution);
+    fixture->SetSensor(fixture_state.sensor);
+    fixture->SetFilterData(fixture_state.filter);
+  }
+  body->ResetMassData();
+}
+
+void WorldSnapshot::RestoreJoint(const JointState& state) {
+  if (state.type != e_revoluteJoint)
+    return;
+  b2RevoluteJoint* revolute = static_cast<b2RevoluteJoint*>(state.joint);
+  revolute->EnableMotor(state.motor_enabled);
+  revolute->SetMotorSpeed(state.motor_speed);
+  revolute->SetMaxMotorTorque(state.max_motor_torque);
+  revolute->EnableLimit(state.limit_enabled);
+  revolute->SetLimits(state.lower_limit, state.upper_limit);
+}
+
+void WorldSnapshot::Restore(b2World* world, CCNode* root) {
+  assert(CanRestore(world));
+
+  RemoveNewNodes(root);
+
+  // Destroy joints and then bodies created since the snapshot.  Joints
+  // go first since destroying a body also destroys its joints.  None of
+  // these are in the snapshot, so the listener ignores them.
+  b2Joint* joint = world->GetJointList();
+  while (joint) {
+    b2Joint* next = joint->GetNext();
+    if (!FindJoint(joint))
+      world->DestroyJoint(joint);
+    joint = next;
+  }
+
+  b2Body* body = world->GetBodyList();
+  while (body) {
+    b2Body* next = body->GetNext();
+    if (!FindBody(body))
+      world->DestroyBody(body);
+    body = next;
+  }
+
+  for (size_t i = 0; i < bodies_.size(); i++) {
+    const BodyState& state = bodies_[i];
+    // Deactivating the body destroys all of its contacts so that they
+    // are recreated from scratch at the restored position.
+    state.body->SetActive(false);
+    state.body->SetType(state.type);
+    RestoreFixtures(state);
+    state.body->SetTransform(state.position, state.angle);
+    state.body->SetLinearVelocity(state.linear_velocity);
+    state.body->SetAngularVelocity(state.angular_velocity);
+    state.body->SetActive(state.active);
+    state.body->SetAwake(state.awake);
+  }
+  // The joints' accumulated impulses can't be reset through the box2d
+  // API.  They only warm start the solver and die away within a few
+  // steps.
+  for (size_t i = 0; i < joints_.size(); i++)
+    RestoreJoint(joints_[i]);
+  world->ClearForces();
+
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    const NodeState& state = nodes_[i];
+    CCNode* node = state.node;
+    node->stopAllActions();
+    // The transform of physics nodes comes from their body.
+    if (!state.has_body) {
+      node->setPosition(state.position);
+      node->setRotation(state.rotation);
+    }
+    node->setScaleX(state.scale_x);
+    node->setScaleY(state.scale_y);
+    node->setVisible(state.visible);
+    if (state.has_rgba) {
+      CCRGBAProtocol* rgba = dynamic_cast<CCRGBAProtocol*>(node);
+      rgba->setOpacity(state.opacity);
+      rgba->setColor(state.color);
+    }
+    PhysicsBodyNode* physics_node = dynamic_cast<PhysicsBodyNode*>(node);
+    if (physics_node)
+      physics_node->ResetPhysicsState();
+  }
+}
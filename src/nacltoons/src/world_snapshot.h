@@ -0,0 +1,129 @@
+// Copyright (c) 2013 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+#ifndef WORLD_SNAPSHOT_H_
+#define WORLD_SNAPSHOT_H_
+
+#include <vector>
+
+#include "cocos2d.h"
+#include "Box2D/Box2D.h"
+
+USING_NS_CC;
+
+/**
+ * Snapshot of the state of a box2d world and the scene graph that
+ * renders it.  Used to restart a level in place: restoring the
+ * snapshot removes any bodies, joints, fixtures and nodes created since
+ * it was captured and resets the state of the remaining ones.
+ *
+ * Box2D reuses the memory of destroyed bodies and joints, so their
+ * pointers alone can't tell whether they are still the captured ones.
+ * The snapshot is therefore the world's destruction listener while it
+ * is held, and is invalidated as soon as a captured joint, or a fixture
+ * of a captured body, is destroyed along with its body.
+ */
+class WorldSnapshot : public b2DestructionListener {
+ public:
+  WorldSnapshot();
+  ~WorldSnapshot();
+
+  // Record the current state of the world and of all nodes below root.
+  // The state of root itself is not recorded.  This replaces the
+  // world's destruction listener.
+  void Capture(b2World* world, CCNode* root);
+
+  // Returns true if a snapshot was captured and none of the bodies,
+  // joints, fixtures or nodes it refers to have since been destroyed
+  // or replaced.
+  bool CanRestore(b2World* world) const;
+
+  // Restore the world and scene graph to the captured state.
+  void Restore(b2World* world, CCNode* root);
+
+  void Clear();
+
+  // b2DestructionListener
+  virtual void SayGoodbye(b2Joint* joint);
+  virtual void SayGoodbye(b2Fixture* fixture);
+
+ private:
+  struct BodyState {
+    b2Body* body;
+    void* user_data;
+    b2BodyType type;
+    b2Vec2 position;
+    float32 angle;
+    b2Vec2 linear_velocity;
+    float32 angular_velocity;
+    bool awake;
+    bool active;
+    // Range of the body's fixtures in fixtures_.
+    int first_fixture;
+    int fixture_count;
+  };
+
+  struct FixtureState {
+    b2Fixture* fixture;
+    float32 density;
+    float32 friction;
+    float32 restitution;
+    bool sensor;
+    b2Filter filter;
+  };
+
+  struct JointState {
+    b2Joint* joint;
+    b2JointType type;
+    b2Body* body_a;
+    b2Body* body_b;
+    // Settings of revolute joints, which the lua scripts can change.
+    bool motor_enabled;
+    float32 motor_speed;
+    float32 max_motor_torque;
+    bool limit_enabled;
+    float32 lower_limit;
+    float32 upper_limit;
+  };
+
+  struct NodeState {
+    CCNode* node;
+    CCNode* parent;
+    CCPoint position;
+    float rotation;
+    float scale_x;
+    float scale_y;
+    bool visible;
+    bool has_body;
+    bool has_rgba;
+    GLubyte opacity;
+    ccColor3B color;
+  };
+
+  static bool CompareBodies(const BodyState& state1, const BodyState& state2);
+  static bool CompareFixtures(const FixtureState& state1,
+                              const FixtureState& state2);
+  static bool CompareJoints(const JointState& state1,
+                            const JointState& state2);
+  static bool CompareNodes(const NodeState& state1, const NodeState& state2);
+  void CaptureNode(CCNode* node);
+  void RemoveNewNodes(CCNode* node);
+  const BodyState* FindBody(b2Body* body) const;
+  const JointState* FindJoint(b2Joint* joint) const;
+  bool InSnapshot(CCNode* node) const;
+  bool HasFixture(const BodyState& state, b2Fixture* fixture) const;
+  void RestoreFixtures(const BodyState& state);
+  void RestoreJoint(const JointState& state);
+
+  bool captured_;
+  // Set when a captured body or joint is destroyed.
+  bool invalidated_;
+  // Bodies, joints and nodes, and the fixtures of each body, are sorted
+  // by pointer so that they can be looked up quickly.
+  std::vector<BodyState> bodies_;
+  std::vector<FixtureState> fixtures_;
+  std::vector<JointState> joints_;
+  std::vector<NodeState> nodes_;
+};
+
+#endif  // WORLD_SNAPSHOT_H_
@@ -29,3 +29,87 @@ function test_LevelDefInvalidKey()
     end
     assert_error("invalid key failed to generate error", doError)
 end
+
+function test_GameDefPhysics()
+    validate.ValidateGameDef('dummygame.def', { physics = { velocity_iterations = 8, native_step = false, threaded = true } })
+end
+
+function test_LevelDefPhysicsInvalidKey()
+    local function doError()
+        validate.ValidateLevelDef('dummylevel.def', { }, { physics = { foo = 1 } })
+    end
+    assert_error("invalid physics key failed to generate error", doError)
+end
+
+function test_LevelDefPhysicsInvalidValue()
+    local function doError()
+        validate.ValidateLevelDef('dummylevel.def', { }, { physics = { native_step = 'yes' } })
+    end
+    assert_error("invalid physics value failed to generate error", doError)
+end
+
+function test_LevelDefPhysicsStepBudget()
+    validate.ValidateLevelDef('dummylevel.def', { }, { physics = { step_budget = 8 } })
+end
+
+function test_GameDefPhysicsWorldSettings()
+    validate.ValidateGameDef('dummygame.def', { physics = { gravity = { 0, -9.8 }, allow_sleeping = true,
+                                                            continuous = false, warm_starting = true,
+                                                            sub_stepping = false, rate = 60, max_steps = 5 } })
+end
+
+function test_LevelDefPhysicsInvalidGravity()
+    local function doError()
+        validate.ValidateLevelDef('dummylevel.def', { }, { physics = { gravity = { 0 } } })
+    end
+    assert_error("invalid gravity failed to generate error", doError)
+end
+
+function test_LevelDefPhysicsInvalidRate()
+    local function doError()
+        validate.ValidateLevelDef('dummylevel.def', { }, { physics = { rate = 0 } })
+    end
+    assert_error("invalid rate failed to generate error", doError)
+end
+
+function test_LevelDefShapeBullet()
+    validate.ValidateLevelDef('dummylevel.def', { }, { shapes = { { type = 'image', dynamic = true, bullet = true } } })
+end
+
+function test_LevelDefShapeInvalidBullet()
+    local function doError()
+        validate.ValidateLevelDef('dummylevel.def', { }, { shapes = { { type = 'image', bullet = 'yes' } } })
+    end
+    assert_error("invalid bullet value failed to generate error", doError)
+end
+
+function test_LevelDefShapeTrigger()
+    validate.ValidateLevelDef('dummylevel.def', { }, { shapes = { { type = 'image', trigger = true },
+                                                                { type = 'image', trigger_activator = true } } })
+end
+
+function test_LevelDefShapeInvalidTrigger()
+    local function doError()
+        validate.ValidateLevelDef('dummylevel.def', { }, { shapes = { { type = 'line', trigger = true } } })
+    end
+    assert_error("trigger on a line failed to generate error", doError)
+end
+
+function test_LevelDefImpactThreshold()
+    validate.ValidateLevelDef('dummylevel.def', { }, { physics = { impact_threshold = 2 },
+                                                       shapes = { { type = 'image', impact_threshold = 0.5 } } })
+end
+
+function test_LevelDefInvalidImpactThreshold()
+    local function doError()
+        validate.ValidateLevelDef('dummylevel.def', { }, { shapes = { { type = 'image', impact_threshold = 'hard' } } })
+    end
+    assert_error("invalid impact_threshold failed to generate error", doError)
+end
+
+function test_GameDefPhysicsInvalidThreaded()
+    local function doError()
+        validate.ValidateGameDef('dummygame.def', { physics = { threaded = 1 } })
+    end
+    assert_error("invalid threaded value failed to generate error", doError)
+end